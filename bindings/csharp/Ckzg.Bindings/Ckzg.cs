@@ -7,6 +7,10 @@ public class Ckzg
 {
     public const int CommitmentLength = 48;
     public const int BlobElementLength = 32;
+    /// <summary>
+    /// Blob length of the mainnet preset, the largest supported; the blobs passed with a trusted setup
+    /// must be <see cref="FieldElementsPerBlob"/> elements long
+    /// </summary>
     public const int BlobLength = BlobElementLength * 4096;
     public const int ProofLength = 48;
 
@@ -75,6 +79,14 @@ public class Ckzg
     [DllImport("ckzg", EntryPoint = "load_trusted_setup_wrap")] // free result with free_trusted_setup()
     public static extern IntPtr LoadTrustedSetup(string filename);
 
+    /// <summary>
+    /// Number of field elements per blob of the trusted setup, which selects the preset
+    /// </summary>
+    /// <param name="ts">Trusted setup settings</param>
+    /// <returns>Returns the number of field elements per blob</returns>
+    [DllImport("ckzg", EntryPoint = "kzg_settings_field_elements_per_blob", CallingConvention = CallingConvention.Cdecl)]
+    public static extern ulong FieldElementsPerBlob(IntPtr ts);
+
     /// <summary>
     /// Frees memory allocated for trusted setup settings
     /// </summary>
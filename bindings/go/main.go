@@ -4,9 +4,68 @@ package cgokzg4844
 // #cgo CFLAGS: -I${SRCDIR}/blst_headers
 // #cgo CFLAGS: -DFIELD_ELEMENTS_PER_BLOB=4096
 // #include "c_kzg_4844.c"
+//
+// // The batch functions below run one task per item on the executor of the
+// // settings, so that a whole batch takes a single cgo call.
+//
+// typedef struct {
+//     KZGCommitment *out;
+//     const Blob *blobs;
+//     C_KZG_RET *rets;
+//     const KZGSettings *s;
+// } CommitmentsTask;
+//
+// static void commitment_task(void *arg, size_t i) {
+//     CommitmentsTask *t = arg;
+//     t->rets[i] = blob_to_kzg_commitment(&t->out[i], &t->blobs[i], t->s);
+// }
+//
+// static C_KZG_RET blob_to_kzg_commitments(KZGCommitment *out, const Blob *blobs, size_t n, const KZGSettings *s) {
+//     C_KZG_RET ret;
+//     CommitmentsTask t = {out, blobs, NULL, s};
+//     ret = c_kzg_calloc((void **)&t.rets, n, sizeof(C_KZG_RET));
+//     if (ret != C_KZG_OK) return ret;
+//     run_parallel(s, commitment_task, &t, n);
+//     for (size_t i = 0; i < n && ret == C_KZG_OK; i++) ret = t.rets[i];
+//     c_kzg_free(t.rets);
+//     return ret;
+// }
+//
+// typedef struct {
+//     bool *out;
+//     const Bytes48 *commitments;
+//     const Bytes32 *zs;
+//     const Bytes32 *ys;
+//     const Bytes48 *proofs;
+//     C_KZG_RET *rets;
+//     const KZGSettings *s;
+// } VerifyTask;
+//
+// static void verify_task(void *arg, size_t i) {
+//     VerifyTask *t = arg;
+//     t->rets[i] = verify_kzg_proof(&t->out[i], &t->commitments[i], &t->zs[i], &t->ys[i], &t->proofs[i], t->s);
+// }
+//
+// static C_KZG_RET verify_kzg_proof_batch(bool *out, const Bytes48 *commitments, const Bytes32 *zs, const Bytes32 *ys,
+//                                         const Bytes48 *proofs, size_t n, const KZGSettings *s) {
+//     C_KZG_RET ret;
+//     VerifyTask t = {out, commitments, zs, ys, proofs, NULL, s};
+//     ret = c_kzg_calloc((void **)&t.rets, n, sizeof(C_KZG_RET));
+//     if (ret != C_KZG_OK) return ret;
+//     run_parallel(s, verify_task, &t, n);
+//     for (size_t i = 0; i < n && ret == C_KZG_OK; i++) ret = t.rets[i];
+//     c_kzg_free(t.rets);
+//     return ret;
+// }
+//
+// // Does nothing, so that benchmarks can measure the cost of a cgo call alone.
+// static void noop(const void *p) {
+//     (void)p;
+// }
 import "C"
 
 import (
+	"runtime"
 	"unsafe"
 
 	// So its functions are available during compilation.
@@ -37,80 +96,113 @@ const (
 	C_KZG_MALLOC  CKzgRet = C.C_KZG_MALLOC
 )
 
-var (
-	loaded   = false
-	settings = C.KZGSettings{}
-)
-
 /*
-LoadTrustedSetup is the binding for:
+Context holds a trusted setup and the threads that batch calls fan out to.
 
-	C_KZG_RET load_trusted_setup(
-	    KZGSettings *out,
-	    const uint8_t *g1_bytes,
-	    size_t n1,
-	    const uint8_t *g2_bytes,
-	    size_t n2);
+Unlike the package-level functions, which share one global setup, any number
+of contexts can be live at once, and all methods may be called concurrently.
+Blobs are passed by pointer or slice, so no 128 KB copies are made on the way
+into C. As a Blob has the size of a mainnet blob, the library reads blob
+slices at that stride only for setups of FieldElementsPerBlob points, so
+setups of another blob size are rejected.
 */
-func LoadTrustedSetup(g1Bytes, g2Bytes []byte) CKzgRet {
-	if loaded {
-		panic("trusted setup is already loaded")
+type Context struct {
+	settings *C.KZGSettings
+	pool     *C.KZGExecutor
+}
+
+var defaultContext *Context
+
+func newContext(numThreads int) (*Context, CKzgRet) {
+	ctx := &Context{settings: (*C.KZGSettings)(C.calloc(1, C.sizeof_KZGSettings))}
+	if ctx.settings == nil {
+		return nil, C_KZG_MALLOC
+	}
+	if numThreads == 0 {
+		numThreads = runtime.NumCPU()
+	}
+	if numThreads > 1 {
+		ret := C.new_kzg_thread_pool(&ctx.pool, (C.size_t)(numThreads))
+		if CKzgRet(ret) != C_KZG_OK {
+			C.free(unsafe.Pointer(ctx.settings))
+			return nil, CKzgRet(ret)
+		}
+	}
+	return ctx, C_KZG_OK
+}
+
+func (ctx *Context) loaded(ret C.C_KZG_RET) (*Context, CKzgRet) {
+	if CKzgRet(ret) == C_KZG_OK && C.kzg_settings_field_elements_per_blob(ctx.settings) != FieldElementsPerBlob {
+		C.free_trusted_setup(ctx.settings)
+		ret = C.C_KZG_BADARGS
 	}
+	if CKzgRet(ret) != C_KZG_OK {
+		C.free_kzg_thread_pool(ctx.pool)
+		C.free(unsafe.Pointer(ctx.settings))
+		return nil, CKzgRet(ret)
+	}
+	C.set_trusted_setup_executor(ctx.settings, ctx.pool)
+	return ctx, C_KZG_OK
+}
+
+/*
+NewContext loads a trusted setup from its G1 and G2 points, like
+LoadTrustedSetup, into a new context. Batch calls run on numThreads native
+threads, or one per CPU if it is 0. It returns C_KZG_BADARGS for setups of
+other than FieldElementsPerBlob points. Free the context after use.
+*/
+func NewContext(g1Bytes, g2Bytes []byte, numThreads int) (*Context, CKzgRet) {
 	if len(g1Bytes)%48 != 0 {
 		panic("len(g1Bytes) is not a multiple of 48")
 	}
 	if len(g2Bytes)%96 != 0 {
 		panic("len(g2Bytes) is not a multiple of 96")
 	}
-	numG1Elements := len(g1Bytes) / 48
-	numG2Elements := len(g2Bytes) / 96
-	ret := C.load_trusted_setup(
-		&settings,
+	ctx, ret := newContext(numThreads)
+	if ret != C_KZG_OK {
+		return nil, ret
+	}
+	return ctx.loaded(C.load_trusted_setup(
+		ctx.settings,
 		*(**C.uint8_t)(unsafe.Pointer(&g1Bytes)),
-		(C.size_t)(numG1Elements),
+		(C.size_t)(len(g1Bytes)/48),
 		*(**C.uint8_t)(unsafe.Pointer(&g2Bytes)),
-		(C.size_t)(numG2Elements))
-	if CKzgRet(ret) == C_KZG_OK {
-		loaded = true
-	}
-	return CKzgRet(ret)
+		(C.size_t)(len(g2Bytes)/96)))
 }
 
 /*
-LoadTrustedSetupFile is the binding for:
-
-	C_KZG_RET load_trusted_setup_file(
-	    KZGSettings *out,
-	    FILE *in);
+NewContextFromFile loads a trusted setup file, like LoadTrustedSetupFile, into
+a new context. Batch calls run on numThreads native threads, or one per CPU if
+it is 0. It returns C_KZG_BADARGS if the file cannot be opened, or holds a
+setup of other than FieldElementsPerBlob points. Free the context after use.
 */
-func LoadTrustedSetupFile(trustedSetupFile string) CKzgRet {
-	if loaded {
-		panic("trusted setup is already loaded")
-	}
-	fp := C.fopen(C.CString(trustedSetupFile), C.CString("rb"))
+func NewContextFromFile(trustedSetupFile string, numThreads int) (*Context, CKzgRet) {
+	path := C.CString(trustedSetupFile)
+	defer C.free(unsafe.Pointer(path))
+	mode := C.CString("rb")
+	defer C.free(unsafe.Pointer(mode))
+	fp := C.fopen(path, mode)
 	if fp == nil {
-		panic("error reading trusted setup")
+		return nil, C_KZG_BADARGS
 	}
-	ret := C.load_trusted_setup_file(&settings, fp)
-	C.fclose(fp)
-	if CKzgRet(ret) == C_KZG_OK {
-		loaded = true
+	defer C.fclose(fp)
+	ctx, ret := newContext(numThreads)
+	if ret != C_KZG_OK {
+		return nil, ret
 	}
-	return CKzgRet(ret)
+	return ctx.loaded(C.load_trusted_setup_file(ctx.settings, fp))
 }
 
 /*
-FreeTrustedSetup is the binding for:
-
-	void free_trusted_setup(
-	    KZGSettings *s);
+Free releases the trusted setup and threads of the context. It must not be
+called while other calls are using the context.
 */
-func FreeTrustedSetup() {
-	if !loaded {
-		panic("trusted setup isn't loaded")
-	}
-	C.free_trusted_setup(&settings)
-	loaded = false
+func (ctx *Context) Free() {
+	C.free_trusted_setup(ctx.settings)
+	C.free_kzg_thread_pool(ctx.pool)
+	C.free(unsafe.Pointer(ctx.settings))
+	ctx.settings = nil
+	ctx.pool = nil
 }
 
 /*
@@ -121,18 +213,34 @@ BlobToKZGCommitment is the binding for:
 	    const Blob *blob,
 	    const KZGSettings *s);
 */
-func BlobToKZGCommitment(blob Blob) (KZGCommitment, CKzgRet) {
-	if !loaded {
-		panic("trusted setup isn't loaded")
-	}
+func (ctx *Context) BlobToKZGCommitment(blob *Blob) (KZGCommitment, CKzgRet) {
 	commitment := KZGCommitment{}
 	ret := C.blob_to_kzg_commitment(
 		(*C.KZGCommitment)(unsafe.Pointer(&commitment)),
-		(*C.Blob)(unsafe.Pointer(&blob)),
-		&settings)
+		(*C.Blob)(unsafe.Pointer(blob)),
+		ctx.settings)
 	return commitment, CKzgRet(ret)
 }
 
+/*
+BlobToKZGCommitments writes the commitment of each blob to the same index of
+commitments, spreading the blobs over the context's threads in one cgo call.
+*/
+func (ctx *Context) BlobToKZGCommitments(blobs []Blob, commitments []KZGCommitment) CKzgRet {
+	if len(blobs) != len(commitments) {
+		panic("len(blobs) != len(commitments)")
+	}
+	if len(blobs) == 0 {
+		return C_KZG_OK
+	}
+	ret := C.blob_to_kzg_commitments(
+		(*C.KZGCommitment)(unsafe.Pointer(&commitments[0])),
+		(*C.Blob)(unsafe.Pointer(&blobs[0])),
+		(C.size_t)(len(blobs)),
+		ctx.settings)
+	return CKzgRet(ret)
+}
+
 /*
 ComputeKZGProof is the binding for:
 
@@ -142,16 +250,13 @@ ComputeKZGProof is the binding for:
 			const Bytes32 *z_bytes,
 			const KZGSettings *s);
 */
-func ComputeKZGProof(blob Blob, zBytes Bytes32) (KZGProof, CKzgRet) {
-	if !loaded {
-		panic("trusted setup isn't loaded")
-	}
+func (ctx *Context) ComputeKZGProof(blob *Blob, zBytes Bytes32) (KZGProof, CKzgRet) {
 	proof := KZGProof{}
 	ret := C.compute_kzg_proof(
 		(*C.KZGProof)(unsafe.Pointer(&proof)),
-		(*C.Blob)(unsafe.Pointer(&blob)),
+		(*C.Blob)(unsafe.Pointer(blob)),
 		(*C.Bytes32)(unsafe.Pointer(&zBytes)),
-		&settings)
+		ctx.settings)
 	return proof, CKzgRet(ret)
 }
 
@@ -166,10 +271,7 @@ VerifyKZGProof is the binding for:
 	    const Bytes48 *proof_bytes,
 	    const KZGSettings *s);
 */
-func VerifyKZGProof(commitmentBytes Bytes48, zBytes, yBytes Bytes32, proofBytes Bytes48) (bool, CKzgRet) {
-	if !loaded {
-		panic("trusted setup isn't loaded")
-	}
+func (ctx *Context) VerifyKZGProof(commitmentBytes Bytes48, zBytes, yBytes Bytes32, proofBytes Bytes48) (bool, CKzgRet) {
 	var result C.bool
 	ret := C.verify_kzg_proof(
 		&result,
@@ -177,10 +279,34 @@ func VerifyKZGProof(commitmentBytes Bytes48, zBytes, yBytes Bytes32, proofBytes
 		(*C.Bytes32)(unsafe.Pointer(&zBytes)),
 		(*C.Bytes32)(unsafe.Pointer(&yBytes)),
 		(*C.Bytes48)(unsafe.Pointer(&proofBytes)),
-		&settings)
+		ctx.settings)
 	return bool(result), CKzgRet(ret)
 }
 
+/*
+VerifyKZGProofBatch verifies the proof at each index of the slices, writing
+whether it is valid to the same index of results. The proofs are spread over
+the context's threads in one cgo call.
+*/
+func (ctx *Context) VerifyKZGProofBatch(commitmentsBytes []Bytes48, zsBytes, ysBytes []Bytes32, proofsBytes []Bytes48, results []bool) CKzgRet {
+	n := len(commitmentsBytes)
+	if len(zsBytes) != n || len(ysBytes) != n || len(proofsBytes) != n || len(results) != n {
+		panic("slices have different lengths")
+	}
+	if n == 0 {
+		return C_KZG_OK
+	}
+	ret := C.verify_kzg_proof_batch(
+		(*C.bool)(unsafe.Pointer(&results[0])),
+		(*C.Bytes48)(unsafe.Pointer(&commitmentsBytes[0])),
+		(*C.Bytes32)(unsafe.Pointer(&zsBytes[0])),
+		(*C.Bytes32)(unsafe.Pointer(&ysBytes[0])),
+		(*C.Bytes48)(unsafe.Pointer(&proofsBytes[0])),
+		(C.size_t)(n),
+		ctx.settings)
+	return CKzgRet(ret)
+}
+
 /*
 ComputeAggregateKZGProof is the binding for:
 
@@ -190,16 +316,13 @@ ComputeAggregateKZGProof is the binding for:
 	    size_t n,
 	    const KZGSettings *s);
 */
-func ComputeAggregateKZGProof(blobs []Blob) (KZGProof, CKzgRet) {
-	if !loaded {
-		panic("trusted setup isn't loaded")
-	}
+func (ctx *Context) ComputeAggregateKZGProof(blobs []Blob) (KZGProof, CKzgRet) {
 	proof := KZGProof{}
 	ret := C.compute_aggregate_kzg_proof(
 		(*C.KZGProof)(unsafe.Pointer(&proof)),
 		*(**C.Blob)(unsafe.Pointer(&blobs)),
 		(C.size_t)(len(blobs)),
-		&settings)
+		ctx.settings)
 	return proof, CKzgRet(ret)
 }
 
@@ -214,10 +337,7 @@ VerifyAggregateKZGProof is the binding for:
 	    const Bytes48 *aggregated_proof_bytes,
 	    const KZGSettings *s);
 */
-func VerifyAggregateKZGProof(blobs []Blob, commitmentsBytes []Bytes48, aggregatedProofBytes Bytes48) (bool, CKzgRet) {
-	if !loaded {
-		panic("trusted setup isn't loaded")
-	}
+func (ctx *Context) VerifyAggregateKZGProof(blobs []Blob, commitmentsBytes []Bytes48, aggregatedProofBytes *Bytes48) (bool, CKzgRet) {
 	if len(blobs) != len(commitmentsBytes) {
 		panic("len(blobs) != len(commitments)")
 	}
@@ -227,7 +347,127 @@ func VerifyAggregateKZGProof(blobs []Blob, commitmentsBytes []Bytes48, aggregate
 		*(**C.Blob)(unsafe.Pointer(&blobs)),
 		*(**C.Bytes48)(unsafe.Pointer(&commitmentsBytes)),
 		(C.size_t)(len(blobs)),
-		(*C.Bytes48)(unsafe.Pointer(&aggregatedProofBytes)),
-		&settings)
+		(*C.Bytes48)(unsafe.Pointer(aggregatedProofBytes)),
+		ctx.settings)
 	return bool(result), CKzgRet(ret)
 }
+
+/*
+The package-level functions below use one global trusted setup, and run every
+call on the calling thread.
+*/
+
+func getDefaultContext() *Context {
+	if defaultContext == nil {
+		panic("trusted setup isn't loaded")
+	}
+	return defaultContext
+}
+
+/*
+LoadTrustedSetup is the binding for:
+
+	C_KZG_RET load_trusted_setup(
+	    KZGSettings *out,
+	    const uint8_t *g1_bytes,
+	    size_t n1,
+	    const uint8_t *g2_bytes,
+	    size_t n2);
+*/
+func LoadTrustedSetup(g1Bytes, g2Bytes []byte) CKzgRet {
+	if defaultContext != nil {
+		panic("trusted setup is already loaded")
+	}
+	ctx, ret := NewContext(g1Bytes, g2Bytes, 1)
+	defaultContext = ctx
+	return ret
+}
+
+/*
+LoadTrustedSetupFile is the binding for:
+
+	C_KZG_RET load_trusted_setup_file(
+	    KZGSettings *out,
+	    FILE *in);
+*/
+func LoadTrustedSetupFile(trustedSetupFile string) CKzgRet {
+	if defaultContext != nil {
+		panic("trusted setup is already loaded")
+	}
+	ctx, ret := NewContextFromFile(trustedSetupFile, 1)
+	defaultContext = ctx
+	return ret
+}
+
+/*
+FreeTrustedSetup is the binding for:
+
+	void free_trusted_setup(
+	    KZGSettings *s);
+*/
+func FreeTrustedSetup() {
+	getDefaultContext().Free()
+	defaultContext = nil
+}
+
+/*
+BlobToKZGCommitment is the binding for blob_to_kzg_commitment with the global
+trusted setup. Context.BlobToKZGCommitment avoids copying the blob.
+*/
+func BlobToKZGCommitment(blob Blob) (KZGCommitment, CKzgRet) {
+	return getDefaultContext().BlobToKZGCommitment(&blob)
+}
+
+/*
+BlobToKZGCommitments writes the commitment of each blob to the same index of
+commitments in one cgo call, with the global trusted setup.
+*/
+func BlobToKZGCommitments(blobs []Blob, commitments []KZGCommitment) CKzgRet {
+	return getDefaultContext().BlobToKZGCommitments(blobs, commitments)
+}
+
+/*
+ComputeKZGProof is the binding for compute_kzg_proof with the global trusted
+setup. Context.ComputeKZGProof avoids copying the blob.
+*/
+func ComputeKZGProof(blob Blob, zBytes Bytes32) (KZGProof, CKzgRet) {
+	return getDefaultContext().ComputeKZGProof(&blob, zBytes)
+}
+
+/*
+VerifyKZGProof is the binding for verify_kzg_proof with the global trusted
+setup.
+*/
+func VerifyKZGProof(commitmentBytes Bytes48, zBytes, yBytes Bytes32, proofBytes Bytes48) (bool, CKzgRet) {
+	return getDefaultContext().VerifyKZGProof(commitmentBytes, zBytes, yBytes, proofBytes)
+}
+
+/*
+VerifyKZGProofBatch verifies the proof at each index of the slices in one cgo
+call, with the global trusted setup.
+*/
+func VerifyKZGProofBatch(commitmentsBytes []Bytes48, zsBytes, ysBytes []Bytes32, proofsBytes []Bytes48, results []bool) CKzgRet {
+	return getDefaultContext().VerifyKZGProofBatch(commitmentsBytes, zsBytes, ysBytes, proofsBytes, results)
+}
+
+/*
+ComputeAggregateKZGProof is the binding for compute_aggregate_kzg_proof with
+the global trusted setup.
+*/
+func ComputeAggregateKZGProof(blobs []Blob) (KZGProof, CKzgRet) {
+	return getDefaultContext().ComputeAggregateKZGProof(blobs)
+}
+
+/*
+VerifyAggregateKZGProof is the binding for verify_aggregate_kzg_proof with the
+global trusted setup.
+*/
+func VerifyAggregateKZGProof(blobs []Blob, commitmentsBytes []Bytes48, aggregatedProofBytes Bytes48) (bool, CKzgRet) {
+	return getDefaultContext().VerifyAggregateKZGProof(blobs, commitmentsBytes, &aggregatedProofBytes)
+}
+
+// cgoNoop crosses into C and back without doing any work, passing blob like
+// the real bindings do. It exists for the overhead benchmarks.
+func cgoNoop(blob *Blob) {
+	C.noop(unsafe.Pointer(blob))
+}
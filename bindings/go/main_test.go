@@ -143,14 +143,94 @@ func TestVerifyKZGProof(t *testing.T) {
 	}
 }
 
+func TestContextBlobToKZGCommitments(t *testing.T) {
+	ctx, ret := NewContextFromFile("../../src/trusted_setup.txt", 4)
+	require.Equal(t, C_KZG_OK, ret)
+	defer ctx.Free()
+
+	const length = 9
+	blobs := make([]Blob, length)
+	for i := range blobs {
+		blobs[i] = GetRandBlob(int64(i))
+	}
+	commitments := make([]KZGCommitment, length)
+	ret = ctx.BlobToKZGCommitments(blobs, commitments)
+	require.Equal(t, C_KZG_OK, ret)
+	for i := range blobs {
+		commitment, ret := BlobToKZGCommitment(blobs[i])
+		require.Equal(t, C_KZG_OK, ret)
+		require.Equal(t, commitment, commitments[i])
+		commitment, ret = ctx.BlobToKZGCommitment(&blobs[i])
+		require.Equal(t, C_KZG_OK, ret)
+		require.Equal(t, commitment, commitments[i])
+	}
+}
+
+func TestNewContextFromFileErrors(t *testing.T) {
+	ctx, ret := NewContextFromFile("../../src/does_not_exist.txt", 1)
+	require.Equal(t, C_KZG_BADARGS, ret)
+	require.Nil(t, ctx)
+
+	// Blob slices are laid out for mainnet blobs.
+	ctx, ret = NewContextFromFile("../../src/trusted_setup_4.txt", 1)
+	require.Equal(t, C_KZG_BADARGS, ret)
+	require.Nil(t, ctx)
+}
+
+func TestVerifyKZGProofBatch(t *testing.T) {
+	type Test struct {
+		TestCases []struct {
+			Proof        Bytes48 `json:"Proof"`
+			Commitment   Bytes48 `json:"Commitment"`
+			InputPoint   Bytes32 `json:"InputPoint"`
+			ClaimedValue Bytes32 `json:"ClaimedValue"`
+		}
+	}
+
+	testFile, err := os.Open("../rust/test_vectors/public_verify_kzg_proof.json")
+	require.NoError(t, err)
+	defer testFile.Close()
+	test := Test{}
+	err = json.NewDecoder(testFile).Decode(&test)
+	require.NoError(t, err)
+
+	n := len(test.TestCases)
+	commitments := make([]Bytes48, n)
+	zs := make([]Bytes32, n)
+	ys := make([]Bytes32, n)
+	proofs := make([]Bytes48, n)
+	for i, tc := range test.TestCases {
+		commitments[i] = tc.Commitment
+		zs[i] = tc.InputPoint
+		ys[i] = tc.ClaimedValue
+		proofs[i] = tc.Proof
+	}
+	// Claim a different value for the last proof, which must then fail.
+	ys[n-1] = Bytes32{}
+
+	ctx, ret := NewContextFromFile("../../src/trusted_setup.txt", 0)
+	require.Equal(t, C_KZG_OK, ret)
+	defer ctx.Free()
+
+	results := make([]bool, n)
+	ret = ctx.VerifyKZGProofBatch(commitments, zs, ys, proofs, results)
+	require.Equal(t, C_KZG_OK, ret)
+	for i := range results {
+		expected, ret := VerifyKZGProof(commitments[i], zs[i], ys[i], proofs[i])
+		require.Equal(t, C_KZG_OK, ret)
+		require.Equal(t, expected, results[i])
+	}
+	require.True(t, results[0])
+	require.False(t, results[n-1])
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Benchmarks
 ///////////////////////////////////////////////////////////////////////////////
 
-func Benchmark(b *testing.B) {
-	const length = 64
-	blobs := [length]Blob{}
-	commitments := [length]Bytes48{}
+func benchmarkInputs(length int) ([]Blob, []Bytes48, Bytes32, Bytes32, Bytes48) {
+	blobs := make([]Blob, length)
+	commitments := make([]Bytes48, length)
 	for i := 0; i < length; i++ {
 		blobs[i] = GetRandBlob(int64(i))
 		commitment, _ := BlobToKZGCommitment(blobs[i])
@@ -160,22 +240,51 @@ func Benchmark(b *testing.B) {
 	y := Bytes32{4, 5, 6}
 	trustedProof, _ := ComputeAggregateKZGProof(blobs[:1])
 	proof := Bytes48(trustedProof)
+	return blobs, commitments, z, y, proof
+}
+
+func Benchmark(b *testing.B) {
+	const length = 64
+	blobs, commitments, z, y, proof := benchmarkInputs(length)
+
+	ctx, ret := NewContextFromFile("../../src/trusted_setup.txt", 0)
+	require.Equal(b, C_KZG_OK, ret)
+	defer ctx.Free()
 
 	b.Run("BlobToKZGCommitment", func(b *testing.B) {
+		b.ReportAllocs()
 		for n := 0; n < b.N; n++ {
 			_, ret := BlobToKZGCommitment(blobs[0])
 			require.Equal(b, C_KZG_OK, ret)
 		}
 	})
 
+	b.Run("Context.BlobToKZGCommitment", func(b *testing.B) {
+		b.ReportAllocs()
+		for n := 0; n < b.N; n++ {
+			_, ret := ctx.BlobToKZGCommitment(&blobs[0])
+			require.Equal(b, C_KZG_OK, ret)
+		}
+	})
+
 	b.Run("ComputeKZGProof", func(b *testing.B) {
+		b.ReportAllocs()
 		for n := 0; n < b.N; n++ {
 			_, ret := ComputeKZGProof(blobs[0], z)
 			require.Equal(b, C_KZG_OK, ret)
 		}
 	})
 
+	b.Run("Context.ComputeKZGProof", func(b *testing.B) {
+		b.ReportAllocs()
+		for n := 0; n < b.N; n++ {
+			_, ret := ctx.ComputeKZGProof(&blobs[0], z)
+			require.Equal(b, C_KZG_OK, ret)
+		}
+	})
+
 	b.Run("VerifyKZGProof", func(b *testing.B) {
+		b.ReportAllocs()
 		for n := 0; n < b.N; n++ {
 			_, ret := VerifyKZGProof(commitments[0], z, y, proof)
 			require.Equal(b, C_KZG_OK, ret)
@@ -184,6 +293,7 @@ func Benchmark(b *testing.B) {
 
 	for i := 1; i <= len(blobs); i *= 2 {
 		b.Run(fmt.Sprintf("ComputeAggregateKZGProof(blobs=%v)", i), func(b *testing.B) {
+			b.ReportAllocs()
 			for n := 0; n < b.N; n++ {
 				_, ret := ComputeAggregateKZGProof(blobs[:i])
 				require.Equal(b, C_KZG_OK, ret)
@@ -193,10 +303,184 @@ func Benchmark(b *testing.B) {
 
 	for i := 1; i <= len(blobs); i *= 2 {
 		b.Run(fmt.Sprintf("VerifyAggregateKZGProof(blobs=%v)", i), func(b *testing.B) {
+			b.ReportAllocs()
 			for n := 0; n < b.N; n++ {
 				_, ret := VerifyAggregateKZGProof(blobs[:i], commitments[:i], proof)
 				require.Equal(b, C_KZG_OK, ret)
 			}
 		})
 	}
+
+	for i := 1; i <= len(blobs); i *= 2 {
+		out := make([]KZGCommitment, i)
+		b.Run(fmt.Sprintf("BlobToKZGCommitments(blobs=%v)", i), func(b *testing.B) {
+			b.ReportAllocs()
+			for n := 0; n < b.N; n++ {
+				ret := BlobToKZGCommitments(blobs[:i], out)
+				require.Equal(b, C_KZG_OK, ret)
+			}
+		})
+		b.Run(fmt.Sprintf("Context.BlobToKZGCommitments(blobs=%v)", i), func(b *testing.B) {
+			b.ReportAllocs()
+			for n := 0; n < b.N; n++ {
+				ret := ctx.BlobToKZGCommitments(blobs[:i], out)
+				require.Equal(b, C_KZG_OK, ret)
+			}
+		})
+	}
+
+	// The proofs don't verify, which costs the same as when they do.
+	for i := 1; i <= len(blobs); i *= 2 {
+		zs := make([]Bytes32, i)
+		ys := make([]Bytes32, i)
+		proofs := make([]Bytes48, i)
+		for j := 0; j < i; j++ {
+			zs[j], ys[j], proofs[j] = z, y, proof
+		}
+		results := make([]bool, i)
+		b.Run(fmt.Sprintf("VerifyKZGProofBatch(proofs=%v)", i), func(b *testing.B) {
+			b.ReportAllocs()
+			for n := 0; n < b.N; n++ {
+				ret := VerifyKZGProofBatch(commitments[:i], zs, ys, proofs, results)
+				require.Equal(b, C_KZG_OK, ret)
+			}
+		})
+		b.Run(fmt.Sprintf("Context.VerifyKZGProofBatch(proofs=%v)", i), func(b *testing.B) {
+			b.ReportAllocs()
+			for n := 0; n < b.N; n++ {
+				ret := ctx.VerifyKZGProofBatch(commitments[:i], zs, ys, proofs, results)
+				require.Equal(b, C_KZG_OK, ret)
+			}
+		})
+	}
+}
+
+/*
+BenchmarkParallel calls each function from GOMAXPROCS goroutines at once. Run
+it with -cpu=1,2,4,8 to see how throughput scales with the number of threads.
+*/
+func BenchmarkParallel(b *testing.B) {
+	const length = 16
+	blobs, commitments, z, y, proof := benchmarkInputs(length)
+
+	b.Run("BlobToKZGCommitment", func(b *testing.B) {
+		b.ReportAllocs()
+		b.RunParallel(func(pb *testing.PB) {
+			for pb.Next() {
+				_, ret := BlobToKZGCommitment(blobs[0])
+				require.Equal(b, C_KZG_OK, ret)
+			}
+		})
+	})
+
+	b.Run("ComputeKZGProof", func(b *testing.B) {
+		b.ReportAllocs()
+		b.RunParallel(func(pb *testing.PB) {
+			for pb.Next() {
+				_, ret := ComputeKZGProof(blobs[0], z)
+				require.Equal(b, C_KZG_OK, ret)
+			}
+		})
+	})
+
+	b.Run("VerifyKZGProof", func(b *testing.B) {
+		b.ReportAllocs()
+		b.RunParallel(func(pb *testing.PB) {
+			for pb.Next() {
+				_, ret := VerifyKZGProof(commitments[0], z, y, proof)
+				require.Equal(b, C_KZG_OK, ret)
+			}
+		})
+	})
+
+	for i := 1; i <= len(blobs); i *= 4 {
+		b.Run(fmt.Sprintf("ComputeAggregateKZGProof(blobs=%v)", i), func(b *testing.B) {
+			b.ReportAllocs()
+			b.RunParallel(func(pb *testing.PB) {
+				for pb.Next() {
+					_, ret := ComputeAggregateKZGProof(blobs[:i])
+					require.Equal(b, C_KZG_OK, ret)
+				}
+			})
+		})
+	}
+
+	for i := 1; i <= len(blobs); i *= 4 {
+		b.Run(fmt.Sprintf("VerifyAggregateKZGProof(blobs=%v)", i), func(b *testing.B) {
+			b.ReportAllocs()
+			b.RunParallel(func(pb *testing.PB) {
+				for pb.Next() {
+					_, ret := VerifyAggregateKZGProof(blobs[:i], commitments[:i], proof)
+					require.Equal(b, C_KZG_OK, ret)
+				}
+			})
+		})
+	}
+}
+
+/*
+BenchmarkOverhead separates the cost of crossing into C from the native work.
+A no-op cgo call is the fixed cost of every binding, and passing the blob by
+value shows the cost of copying it. VerifyKZGProof is the cheapest real call,
+so comparing one call per proof against one batch call over all of them, on a
+single thread, gives the per-call overhead at its most visible.
+*/
+func BenchmarkOverhead(b *testing.B) {
+	const length = 64
+	blobs, commitments, z, y, proof := benchmarkInputs(length)
+
+	ctx, ret := NewContextFromFile("../../src/trusted_setup.txt", 1)
+	require.Equal(b, C_KZG_OK, ret)
+	defer ctx.Free()
+
+	b.Run("CgoNoop", func(b *testing.B) {
+		b.ReportAllocs()
+		for n := 0; n < b.N; n++ {
+			cgoNoop(&blobs[0])
+		}
+	})
+
+	b.Run("CgoNoopBlobByValue", func(b *testing.B) {
+		b.ReportAllocs()
+		for n := 0; n < b.N; n++ {
+			blob := blobs[n%length]
+			cgoNoop(&blob)
+		}
+	})
+
+	b.Run("CgoNoopParallel", func(b *testing.B) {
+		b.ReportAllocs()
+		b.RunParallel(func(pb *testing.PB) {
+			var blob Blob
+			for pb.Next() {
+				cgoNoop(&blob)
+			}
+		})
+	})
+
+	zs := make([]Bytes32, length)
+	ys := make([]Bytes32, length)
+	proofs := make([]Bytes48, length)
+	for i := 0; i < length; i++ {
+		zs[i], ys[i], proofs[i] = z, y, proof
+	}
+	results := make([]bool, length)
+
+	b.Run(fmt.Sprintf("VerifyKZGProof(calls=%v)", length), func(b *testing.B) {
+		b.ReportAllocs()
+		for n := 0; n < b.N; n++ {
+			for i := 0; i < length; i++ {
+				_, ret := ctx.VerifyKZGProof(commitments[i], zs[i], ys[i], proofs[i])
+				require.Equal(b, C_KZG_OK, ret)
+			}
+		}
+	})
+
+	b.Run(fmt.Sprintf("VerifyKZGProofBatch(proofs=%v)", length), func(b *testing.B) {
+		b.ReportAllocs()
+		for n := 0; n < b.N; n++ {
+			ret := ctx.VerifyKZGProofBatch(commitments, zs, ys, proofs, results)
+			require.Equal(b, C_KZG_OK, ret)
+		}
+	})
 }
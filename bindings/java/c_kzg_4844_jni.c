@@ -1,20 +1,26 @@
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include "c_kzg_4844_jni.h"
 #include "c_kzg_4844.h"
 
-static const char *TRUSTED_SETUP_NOT_LOADED = "Trusted Setup is not loaded.";
+/*
+ * Settings are owned by the Java KZGContext objects, which pass them to every call as a handle.
+ * The Java side keeps a handle alive for as long as any call is using it.
+ */
 
-KZGSettings *settings;
+KZGSettings *settings_from_handle(jlong handle)
+{
+  return (KZGSettings *)(uintptr_t)handle;
+}
 
-void reset_trusted_setup()
+/*
+ * The library is built for the largest blob size, and each setup selects its own, so sizes are
+ * checked against the setup rather than against BYTES_PER_BLOB.
+ */
+size_t bytes_per_blob(const KZGSettings *settings)
 {
-  if (settings)
-  {
-    free_trusted_setup(settings);
-    free(settings);
-    settings = NULL;
-  }
+  return (size_t)kzg_settings_field_elements_per_blob(settings) * BYTES_PER_FIELD_ELEMENT;
 }
 
 void throw_exception(JNIEnv *env, const char *message)
@@ -39,24 +45,67 @@ void throw_invalid_size_exception(JNIEnv *env, const char *prefix, size_t size,
   throw_c_kzg_exception(env, C_KZG_BADARGS, message);
 }
 
-JNIEXPORT jint JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_getFieldElementsPerBlob(JNIEnv *env, jclass thisCls)
+/*
+ * Copies a small fixed-size array, such as a point or a proof, after checking its size.
+ * Returns false with an exception pending if the size is wrong.
+ */
+bool get_fixed_bytes(JNIEnv *env, jbyteArray array, void *out, size_t size, const char *prefix)
 {
-  return (jint)FIELD_ELEMENTS_PER_BLOB;
+  size_t array_size = (size_t)(*env)->GetArrayLength(env, array);
+  if (array_size != size)
+  {
+    throw_invalid_size_exception(env, prefix, array_size, size);
+    return false;
+  }
+  (*env)->GetByteArrayRegion(env, array, 0, (jsize)size, (jbyte *)out);
+  return true;
 }
 
-JNIEXPORT void JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_loadTrustedSetup__Ljava_lang_String_2(JNIEnv *env, jclass thisCls, jstring file)
+/*
+ * Returns the address of the bytes of a direct buffer from offset, after checking their size.
+ * Returns NULL with an exception pending if the buffer is not direct or the size is wrong.
+ */
+void *get_direct_bytes(JNIEnv *env, jobject buffer, jint offset, jint length, size_t expected_size, const char *prefix)
 {
-  if (settings)
+  if ((size_t)length != expected_size)
   {
-    throw_exception(env, "Trusted Setup is already loaded. Free it before loading a new one.");
-    return;
+    throw_invalid_size_exception(env, prefix, (size_t)length, expected_size);
+    return NULL;
+  }
+  uint8_t *address = (*env)->GetDirectBufferAddress(env, buffer);
+  if (address == NULL)
+  {
+    throw_exception(env, "Buffer is not a direct buffer.");
+    return NULL;
   }
+  return address + offset;
+}
 
-  settings = malloc(sizeof(KZGSettings));
+/*
+ * Wraps a proof or commitment in a new Java array.
+ */
+jbyteArray new_bytes48_array(JNIEnv *env, const Bytes48 *bytes)
+{
+  jbyteArray array = (*env)->NewByteArray(env, BYTES_PER_PROOF);
+  if (array != NULL)
+  {
+    (*env)->SetByteArrayRegion(env, array, 0, BYTES_PER_PROOF, (const jbyte *)bytes);
+  }
+  return array;
+}
+
+JNIEXPORT jint JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_getFieldElementsPerBlob(JNIEnv *env, jclass thisCls, jlong settings_handle)
+{
+  return (jint)kzg_settings_field_elements_per_blob(settings_from_handle(settings_handle));
+}
+
+JNIEXPORT jlong JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_loadTrustedSetupFile(JNIEnv *env, jclass thisCls, jstring file)
+{
+  KZGSettings *settings = malloc(sizeof(KZGSettings));
   if (settings == NULL)
   {
     throw_exception(env, "Failed to allocate memory for the Trusted Setup.");
-    return;
+    return 0;
   }
 
   const char *file_native = (*env)->GetStringUTFChars(env, file, 0);
@@ -65,10 +114,10 @@ JNIEXPORT void JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_loadTrustedSetup__Ljav
 
   if (f == NULL)
   {
-    reset_trusted_setup();
+    free(settings);
     (*env)->ReleaseStringUTFChars(env, file, file_native);
     throw_exception(env, "Couldn't load Trusted Setup. File might not exist or there is a permission issue.");
-    return;
+    return 0;
   }
 
   C_KZG_RET ret = load_trusted_setup_file(settings, f);
@@ -78,25 +127,21 @@ JNIEXPORT void JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_loadTrustedSetup__Ljav
 
   if (ret != C_KZG_OK)
   {
-    reset_trusted_setup();
+    free(settings);
     throw_c_kzg_exception(env, ret, "There was an error while loading the Trusted Setup.");
-    return;
+    return 0;
   }
+
+  return (jlong)(uintptr_t)settings;
 }
 
-JNIEXPORT void JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_loadTrustedSetup___3BJ_3BJ(JNIEnv *env, jclass thisCls, jbyteArray g1, jlong g1Count, jbyteArray g2, jlong g2Count)
+JNIEXPORT jlong JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_loadTrustedSetupBytes(JNIEnv *env, jclass thisCls, jbyteArray g1, jlong g1Count, jbyteArray g2, jlong g2Count)
 {
-  if (settings)
-  {
-    throw_exception(env, "Trusted Setup is already loaded. Free it before loading a new one.");
-    return;
-  }
-
-  settings = malloc(sizeof(KZGSettings));
+  KZGSettings *settings = malloc(sizeof(KZGSettings));
   if (settings == NULL)
   {
     throw_exception(env, "Failed to allocate memory for the Trusted Setup.");
-    return;
+    return 0;
   }
 
   jbyte *g1_native = (*env)->GetByteArrayElements(env, g1, NULL);
@@ -109,40 +154,54 @@ JNIEXPORT void JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_loadTrustedSetup___3BJ
 
   if (ret != C_KZG_OK)
   {
-    reset_trusted_setup();
+    free(settings);
     throw_c_kzg_exception(env, ret, "There was an error while loading the Trusted Setup.");
-    return;
+    return 0;
   }
+
+  return (jlong)(uintptr_t)settings;
 }
 
-JNIEXPORT void JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_freeTrustedSetup(JNIEnv *env, jclass thisCls)
+JNIEXPORT void JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_freeTrustedSetup(JNIEnv *env, jclass thisCls, jlong settings_handle)
 {
-  if (settings == NULL)
-  {
-    throw_exception(env, TRUSTED_SETUP_NOT_LOADED);
-    return;
-  }
-  reset_trusted_setup();
+  KZGSettings *settings = settings_from_handle(settings_handle);
+  free_trusted_setup(settings);
+  free(settings);
 }
 
-JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_computeKzgProof(JNIEnv *env, jclass thisCls, jbyteArray blob, jbyteArray z_bytes)
+/*
+ * The blob-sized arguments are used in place with GetPrimitiveArrayCritical rather than copied
+ * with GetByteArrayElements. No JNI calls are made while they are held, so the results are
+ * computed into native memory and copied into new arrays once the arrays are released.
+ */
+
+JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_computeKzgProof(JNIEnv *env, jclass thisCls, jlong settings_handle, jbyteArray blob, jbyteArray z_bytes)
 {
-  if (settings == NULL)
+  const KZGSettings *settings = settings_from_handle(settings_handle);
+
+  size_t blob_size = (size_t)(*env)->GetArrayLength(env, blob);
+  if (blob_size != bytes_per_blob(settings))
   {
-    throw_exception(env, TRUSTED_SETUP_NOT_LOADED);
+    throw_invalid_size_exception(env, "Invalid blob size.", blob_size, bytes_per_blob(settings));
     return NULL;
   }
 
-  Blob *blob_native = (Blob *)(*env)->GetByteArrayElements(env, blob, NULL);
-  Bytes32 *z_native = (Bytes32 *)(*env)->GetByteArrayElements(env, z_bytes, NULL);
+  Bytes32 z_native;
+  if (!get_fixed_bytes(env, z_bytes, &z_native, BYTES_PER_FIELD_ELEMENT, "Invalid z size."))
+  {
+    return NULL;
+  }
 
-  jbyteArray proof = (*env)->NewByteArray(env, BYTES_PER_PROOF);
-  KZGProof *proof_native = (KZGProof *)(uint8_t *)(*env)->GetByteArrayElements(env, proof, NULL);
+  KZGProof proof_native;
+  void *blob_native = (*env)->GetPrimitiveArrayCritical(env, blob, NULL);
+  if (blob_native == NULL)
+  {
+    return NULL;
+  }
 
-  C_KZG_RET ret = compute_kzg_proof(proof_native, blob_native, z_native, settings);
+  C_KZG_RET ret = compute_kzg_proof(&proof_native, (const Blob *)blob_native, &z_native, settings);
 
-  (*env)->ReleaseByteArrayElements(env, blob, (jbyte *)blob_native, JNI_ABORT);
-  (*env)->ReleaseByteArrayElements(env, proof, (jbyte *)proof_native, 0);
+  (*env)->ReleasePrimitiveArrayCritical(env, blob, blob_native, JNI_ABORT);
 
   if (ret != C_KZG_OK)
   {
@@ -150,19 +209,43 @@ JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_computeKzgProof(
     return NULL;
   }
 
-  return proof;
+  return new_bytes48_array(env, &proof_native);
 }
 
-JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_computeAggregateKzgProof(JNIEnv *env, jclass thisCls, jbyteArray blobs, jlong count)
+JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_computeKzgProofDirect(JNIEnv *env, jclass thisCls, jlong settings_handle, jobject blob, jint blobOffset, jint blobLength, jbyteArray z_bytes)
 {
-  if (settings == NULL)
+  const KZGSettings *settings = settings_from_handle(settings_handle);
+
+  const Blob *blob_native = get_direct_bytes(env, blob, blobOffset, blobLength, bytes_per_blob(settings), "Invalid blob size.");
+  if (blob_native == NULL)
+  {
+    return NULL;
+  }
+
+  Bytes32 z_native;
+  if (!get_fixed_bytes(env, z_bytes, &z_native, BYTES_PER_FIELD_ELEMENT, "Invalid z size."))
   {
-    throw_exception(env, TRUSTED_SETUP_NOT_LOADED);
     return NULL;
   }
 
+  KZGProof proof_native;
+  C_KZG_RET ret = compute_kzg_proof(&proof_native, blob_native, &z_native, settings);
+
+  if (ret != C_KZG_OK)
+  {
+    throw_c_kzg_exception(env, ret, "There was an error while computing kzg proof.");
+    return NULL;
+  }
+
+  return new_bytes48_array(env, &proof_native);
+}
+
+JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_computeAggregateKzgProof(JNIEnv *env, jclass thisCls, jlong settings_handle, jbyteArray blobs, jlong count)
+{
+  const KZGSettings *settings = settings_from_handle(settings_handle);
+
   size_t blobs_size = (size_t)(*env)->GetArrayLength(env, blobs);
-  size_t expected_blobs_size = BYTES_PER_BLOB * (size_t)count;
+  size_t expected_blobs_size = bytes_per_blob(settings) * (size_t)count;
   if (blobs_size != expected_blobs_size)
   {
     throw_invalid_size_exception(env, "Invalid blobs size.", blobs_size, expected_blobs_size);
@@ -170,14 +253,16 @@ JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_computeAggregate
   }
 
   size_t count_native = (size_t)count;
-  jbyte *blobs_native = (*env)->GetByteArrayElements(env, blobs, NULL);
-  jbyteArray proof = (*env)->NewByteArray(env, BYTES_PER_PROOF);
-  KZGProof *proof_native = (KZGProof *)(uint8_t *)(*env)->GetByteArrayElements(env, proof, NULL);
+  KZGProof proof_native;
+  void *blobs_native = (*env)->GetPrimitiveArrayCritical(env, blobs, NULL);
+  if (blobs_native == NULL)
+  {
+    return NULL;
+  }
 
-  C_KZG_RET ret = compute_aggregate_kzg_proof(proof_native, (const Blob *)blobs_native, count_native, settings);
+  C_KZG_RET ret = compute_aggregate_kzg_proof(&proof_native, (const Blob *)blobs_native, count_native, settings);
 
-  (*env)->ReleaseByteArrayElements(env, blobs, blobs_native, JNI_ABORT);
-  (*env)->ReleaseByteArrayElements(env, proof, (jbyte *)proof_native, 0);
+  (*env)->ReleasePrimitiveArrayCritical(env, blobs, blobs_native, JNI_ABORT);
 
   if (ret != C_KZG_OK)
   {
@@ -185,21 +270,40 @@ JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_computeAggregate
     return NULL;
   }
 
-  return proof;
+  return new_bytes48_array(env, &proof_native);
 }
 
-JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_verifyAggregateKzgProof(JNIEnv *env, jclass thisCls, jbyteArray blobs, jbyteArray commitments_bytes, jlong count, jbyteArray proof_bytes)
+JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_computeAggregateKzgProofDirect(JNIEnv *env, jclass thisCls, jlong settings_handle, jobject blobs, jint blobsOffset, jint blobsLength, jlong count)
 {
-  if (settings == NULL)
+  const KZGSettings *settings = settings_from_handle(settings_handle);
+
+  size_t count_native = (size_t)count;
+  const Blob *blobs_native = get_direct_bytes(env, blobs, blobsOffset, blobsLength, bytes_per_blob(settings) * count_native, "Invalid blobs size.");
+  if (blobs_native == NULL)
   {
-    throw_exception(env, TRUSTED_SETUP_NOT_LOADED);
-    return 0;
+    return NULL;
+  }
+
+  KZGProof proof_native;
+  C_KZG_RET ret = compute_aggregate_kzg_proof(&proof_native, blobs_native, count_native, settings);
+
+  if (ret != C_KZG_OK)
+  {
+    throw_c_kzg_exception(env, ret, "There was an error while computing aggregate kzg proof.");
+    return NULL;
   }
 
+  return new_bytes48_array(env, &proof_native);
+}
+
+JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_verifyAggregateKzgProof(JNIEnv *env, jclass thisCls, jlong settings_handle, jbyteArray blobs, jbyteArray commitments_bytes, jlong count, jbyteArray proof_bytes)
+{
+  const KZGSettings *settings = settings_from_handle(settings_handle);
+
   size_t count_native = (size_t)count;
 
   size_t blobs_size = (size_t)(*env)->GetArrayLength(env, blobs);
-  size_t expected_blobs_size = BYTES_PER_BLOB * count_native;
+  size_t expected_blobs_size = bytes_per_blob(settings) * count_native;
   if (blobs_size != expected_blobs_size)
   {
     throw_invalid_size_exception(env, "Invalid blobs size.", blobs_size, expected_blobs_size);
@@ -214,16 +318,29 @@ JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_verifyAggregateKzg
     return 0;
   }
 
-  Bytes48 *proof_native = (Bytes48 *)(*env)->GetByteArrayElements(env, proof_bytes, NULL);
-  Bytes48 *commitments_native = (Bytes48 *)(*env)->GetByteArrayElements(env, commitments_bytes, NULL);
-  jbyte *blobs_native = (*env)->GetByteArrayElements(env, blobs, NULL);
+  Bytes48 proof_native;
+  if (!get_fixed_bytes(env, proof_bytes, &proof_native, BYTES_PER_PROOF, "Invalid proof size."))
+  {
+    return 0;
+  }
+
+  void *blobs_native = (*env)->GetPrimitiveArrayCritical(env, blobs, NULL);
+  if (blobs_native == NULL)
+  {
+    return 0;
+  }
+  void *commitments_native = (*env)->GetPrimitiveArrayCritical(env, commitments_bytes, NULL);
+  if (commitments_native == NULL)
+  {
+    (*env)->ReleasePrimitiveArrayCritical(env, blobs, blobs_native, JNI_ABORT);
+    return 0;
+  }
 
   bool out;
-  C_KZG_RET ret = verify_aggregate_kzg_proof(&out, (const Blob *)blobs_native, commitments_native, count_native, proof_native, settings);
+  C_KZG_RET ret = verify_aggregate_kzg_proof(&out, (const Blob *)blobs_native, (const Bytes48 *)commitments_native, count_native, &proof_native, settings);
 
-  (*env)->ReleaseByteArrayElements(env, proof_bytes, (jbyte *)proof_native, JNI_ABORT);
-  (*env)->ReleaseByteArrayElements(env, commitments_bytes, (jbyte *)commitments_native, JNI_ABORT);
-  (*env)->ReleaseByteArrayElements(env, blobs, blobs_native, JNI_ABORT);
+  (*env)->ReleasePrimitiveArrayCritical(env, commitments_bytes, commitments_native, JNI_ABORT);
+  (*env)->ReleasePrimitiveArrayCritical(env, blobs, blobs_native, JNI_ABORT);
 
   if (ret != C_KZG_OK)
   {
@@ -234,29 +351,63 @@ JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_verifyAggregateKzg
   return (jboolean)out;
 }
 
-JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_blobToKzgCommitment(JNIEnv *env, jclass thisCls, jbyteArray blob)
+JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_verifyAggregateKzgProofDirect(JNIEnv *env, jclass thisCls, jlong settings_handle, jobject blobs, jint blobsOffset, jint blobsLength, jobject commitments_bytes, jint commitmentsOffset, jint commitmentsLength, jlong count, jbyteArray proof_bytes)
 {
-  if (settings == NULL)
+  const KZGSettings *settings = settings_from_handle(settings_handle);
+
+  size_t count_native = (size_t)count;
+
+  const Blob *blobs_native = get_direct_bytes(env, blobs, blobsOffset, blobsLength, bytes_per_blob(settings) * count_native, "Invalid blobs size.");
+  if (blobs_native == NULL)
   {
-    throw_exception(env, TRUSTED_SETUP_NOT_LOADED);
-    return NULL;
+    return 0;
+  }
+
+  const Bytes48 *commitments_native = get_direct_bytes(env, commitments_bytes, commitmentsOffset, commitmentsLength, BYTES_PER_COMMITMENT * count_native, "Invalid commitments size.");
+  if (commitments_native == NULL)
+  {
+    return 0;
+  }
+
+  Bytes48 proof_native;
+  if (!get_fixed_bytes(env, proof_bytes, &proof_native, BYTES_PER_PROOF, "Invalid proof size."))
+  {
+    return 0;
+  }
+
+  bool out;
+  C_KZG_RET ret = verify_aggregate_kzg_proof(&out, blobs_native, commitments_native, count_native, &proof_native, settings);
+
+  if (ret != C_KZG_OK)
+  {
+    throw_c_kzg_exception(env, ret, "There was an error while verifying aggregate kzg proof.");
+    return 0;
   }
 
+  return (jboolean)out;
+}
+
+JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_blobToKzgCommitment(JNIEnv *env, jclass thisCls, jlong settings_handle, jbyteArray blob)
+{
+  const KZGSettings *settings = settings_from_handle(settings_handle);
+
   size_t blob_size = (size_t)(*env)->GetArrayLength(env, blob);
-  if (blob_size != BYTES_PER_BLOB)
+  if (blob_size != bytes_per_blob(settings))
   {
-    throw_invalid_size_exception(env, "Invalid blob size.", blob_size, BYTES_PER_BLOB);
+    throw_invalid_size_exception(env, "Invalid blob size.", blob_size, bytes_per_blob(settings));
     return NULL;
   }
 
-  jbyte *blob_native = (*env)->GetByteArrayElements(env, blob, NULL);
-  jbyteArray commitment = (*env)->NewByteArray(env, BYTES_PER_COMMITMENT);
-  KZGCommitment *commitment_native = (KZGCommitment *)(*env)->GetByteArrayElements(env, commitment, NULL);
+  KZGCommitment commitment_native;
+  void *blob_native = (*env)->GetPrimitiveArrayCritical(env, blob, NULL);
+  if (blob_native == NULL)
+  {
+    return NULL;
+  }
 
-  C_KZG_RET ret = blob_to_kzg_commitment(commitment_native, (const Blob *)blob_native, settings);
+  C_KZG_RET ret = blob_to_kzg_commitment(&commitment_native, (const Blob *)blob_native, settings);
 
-  (*env)->ReleaseByteArrayElements(env, blob, blob_native, JNI_ABORT);
-  (*env)->ReleaseByteArrayElements(env, commitment, (jbyte *)commitment_native, 0);
+  (*env)->ReleasePrimitiveArrayCritical(env, blob, blob_native, JNI_ABORT);
 
   if (ret != C_KZG_OK)
   {
@@ -264,29 +415,47 @@ JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_blobToKzgCommitm
     return NULL;
   }
 
-  return commitment;
+  return new_bytes48_array(env, &commitment_native);
 }
 
-JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_verifyKzgProof(JNIEnv *env, jclass thisCls, jbyteArray commitment_bytes, jbyteArray z_bytes, jbyteArray y_bytes, jbyteArray proof_bytes)
+JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_blobToKzgCommitmentDirect(JNIEnv *env, jclass thisCls, jlong settings_handle, jobject blob, jint blobOffset, jint blobLength)
 {
-  if (settings == NULL)
+  const KZGSettings *settings = settings_from_handle(settings_handle);
+
+  const Blob *blob_native = get_direct_bytes(env, blob, blobOffset, blobLength, bytes_per_blob(settings), "Invalid blob size.");
+  if (blob_native == NULL)
   {
-    throw_exception(env, TRUSTED_SETUP_NOT_LOADED);
-    return 0;
+    return NULL;
   }
 
-  Bytes48 *commitment_native = (Bytes48 *)(*env)->GetByteArrayElements(env, commitment_bytes, NULL);
-  Bytes48 *proof_native = (Bytes48 *)(*env)->GetByteArrayElements(env, proof_bytes, NULL);
-  Bytes32 *z_native = (Bytes32 *)(*env)->GetByteArrayElements(env, z_bytes, NULL);
-  Bytes32 *y_native = (Bytes32 *)(*env)->GetByteArrayElements(env, y_bytes, NULL);
+  KZGCommitment commitment_native;
+  C_KZG_RET ret = blob_to_kzg_commitment(&commitment_native, blob_native, settings);
 
-  bool out;
-  C_KZG_RET ret = verify_kzg_proof(&out, commitment_native, z_native, y_native, proof_native, settings);
+  if (ret != C_KZG_OK)
+  {
+    throw_c_kzg_exception(env, ret, "There was an error while converting blob to commitment.");
+    return NULL;
+  }
+
+  return new_bytes48_array(env, &commitment_native);
+}
 
-  (*env)->ReleaseByteArrayElements(env, commitment_bytes, (jbyte *)commitment_native, JNI_ABORT);
-  (*env)->ReleaseByteArrayElements(env, z_bytes, (jbyte *)z_native, JNI_ABORT);
-  (*env)->ReleaseByteArrayElements(env, y_bytes, (jbyte *)y_native, JNI_ABORT);
-  (*env)->ReleaseByteArrayElements(env, proof_bytes, (jbyte *)proof_native, JNI_ABORT);
+JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_verifyKzgProof(JNIEnv *env, jclass thisCls, jlong settings_handle, jbyteArray commitment_bytes, jbyteArray z_bytes, jbyteArray y_bytes, jbyteArray proof_bytes)
+{
+  const KZGSettings *settings = settings_from_handle(settings_handle);
+
+  Bytes48 commitment_native, proof_native;
+  Bytes32 z_native, y_native;
+  if (!get_fixed_bytes(env, commitment_bytes, &commitment_native, BYTES_PER_COMMITMENT, "Invalid commitment size.") ||
+      !get_fixed_bytes(env, z_bytes, &z_native, BYTES_PER_FIELD_ELEMENT, "Invalid z size.") ||
+      !get_fixed_bytes(env, y_bytes, &y_native, BYTES_PER_FIELD_ELEMENT, "Invalid y size.") ||
+      !get_fixed_bytes(env, proof_bytes, &proof_native, BYTES_PER_PROOF, "Invalid proof size."))
+  {
+    return 0;
+  }
+
+  bool out;
+  C_KZG_RET ret = verify_kzg_proof(&out, &commitment_native, &z_native, &y_native, &proof_native, settings);
 
   if (ret != C_KZG_OK)
   {
@@ -296,3 +465,109 @@ JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_verifyKzgProof(JNI
 
   return (jboolean)out;
 }
+
+/*
+ * The functions below take the same arguments as their counterparts and access them in the same
+ * way, but skip the crypto. The benchmarks use them to measure the cost of crossing JNI apart
+ * from the cost of the native computation.
+ */
+
+JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_noopBlobToKzgCommitment(JNIEnv *env, jclass thisCls, jlong settings_handle, jbyteArray blob)
+{
+  const KZGSettings *settings = settings_from_handle(settings_handle);
+
+  size_t blob_size = (size_t)(*env)->GetArrayLength(env, blob);
+  if (blob_size != bytes_per_blob(settings))
+  {
+    throw_invalid_size_exception(env, "Invalid blob size.", blob_size, bytes_per_blob(settings));
+    return NULL;
+  }
+
+  KZGCommitment commitment_native = {{0}};
+  void *blob_native = (*env)->GetPrimitiveArrayCritical(env, blob, NULL);
+  if (blob_native == NULL)
+  {
+    return NULL;
+  }
+
+  commitment_native.bytes[0] = ((const uint8_t *)blob_native)[0];
+
+  (*env)->ReleasePrimitiveArrayCritical(env, blob, blob_native, JNI_ABORT);
+
+  return new_bytes48_array(env, &commitment_native);
+}
+
+JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_noopVerifyAggregateKzgProof(JNIEnv *env, jclass thisCls, jlong settings_handle, jbyteArray blobs, jbyteArray commitments_bytes, jlong count, jbyteArray proof_bytes)
+{
+  const KZGSettings *settings = settings_from_handle(settings_handle);
+
+  size_t count_native = (size_t)count;
+
+  size_t blobs_size = (size_t)(*env)->GetArrayLength(env, blobs);
+  size_t expected_blobs_size = bytes_per_blob(settings) * count_native;
+  if (blobs_size != expected_blobs_size)
+  {
+    throw_invalid_size_exception(env, "Invalid blobs size.", blobs_size, expected_blobs_size);
+    return 0;
+  }
+
+  size_t commitments_size = (size_t)(*env)->GetArrayLength(env, commitments_bytes);
+  size_t expected_commitments_size = BYTES_PER_COMMITMENT * count_native;
+  if (commitments_size != expected_commitments_size)
+  {
+    throw_invalid_size_exception(env, "Invalid commitments size.", commitments_size, expected_commitments_size);
+    return 0;
+  }
+
+  Bytes48 proof_native;
+  if (!get_fixed_bytes(env, proof_bytes, &proof_native, BYTES_PER_PROOF, "Invalid proof size."))
+  {
+    return 0;
+  }
+
+  void *blobs_native = (*env)->GetPrimitiveArrayCritical(env, blobs, NULL);
+  if (blobs_native == NULL)
+  {
+    return 0;
+  }
+  void *commitments_native = (*env)->GetPrimitiveArrayCritical(env, commitments_bytes, NULL);
+  if (commitments_native == NULL)
+  {
+    (*env)->ReleasePrimitiveArrayCritical(env, blobs, blobs_native, JNI_ABORT);
+    return 0;
+  }
+
+  bool out = count_native > 0 && ((const uint8_t *)blobs_native)[0] == ((const uint8_t *)commitments_native)[0];
+
+  (*env)->ReleasePrimitiveArrayCritical(env, commitments_bytes, commitments_native, JNI_ABORT);
+  (*env)->ReleasePrimitiveArrayCritical(env, blobs, blobs_native, JNI_ABORT);
+
+  return (jboolean)out;
+}
+
+JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_noopVerifyAggregateKzgProofDirect(JNIEnv *env, jclass thisCls, jlong settings_handle, jobject blobs, jint blobsOffset, jint blobsLength, jobject commitments_bytes, jint commitmentsOffset, jint commitmentsLength, jlong count, jbyteArray proof_bytes)
+{
+  const KZGSettings *settings = settings_from_handle(settings_handle);
+
+  size_t count_native = (size_t)count;
+
+  const uint8_t *blobs_native = get_direct_bytes(env, blobs, blobsOffset, blobsLength, bytes_per_blob(settings) * count_native, "Invalid blobs size.");
+  if (blobs_native == NULL)
+  {
+    return 0;
+  }
+
+  const uint8_t *commitments_native = get_direct_bytes(env, commitments_bytes, commitmentsOffset, commitmentsLength, BYTES_PER_COMMITMENT * count_native, "Invalid commitments size.");
+  if (commitments_native == NULL)
+  {
+    return 0;
+  }
+
+  Bytes48 proof_native;
+  if (!get_fixed_bytes(env, proof_bytes, &proof_native, BYTES_PER_PROOF, "Invalid proof size."))
+  {
+    return 0;
+  }
+
+  return (jboolean)(count_native > 0 && blobs_native[0] == commitments_native[0]);
+}
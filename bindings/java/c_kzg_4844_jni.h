@@ -17,65 +17,114 @@ extern "C"
   /*
    * Class:     ethereum_ckzg4844_CKZG4844JNI
    * Method:    getFieldElementsPerBlob
-   * Signature: ()I
+   * Signature: (J)I
    */
-  JNIEXPORT jint JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_getFieldElementsPerBlob(JNIEnv *, jclass);
+  JNIEXPORT jint JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_getFieldElementsPerBlob(JNIEnv *, jclass, jlong);
 
   /*
    * Class:     ethereum_ckzg4844_CKZG4844JNI
-   * Method:    loadTrustedSetup
-   * Signature: (Ljava/lang/String;)V
+   * Method:    loadTrustedSetupFile
+   * Signature: (Ljava/lang/String;)J
    */
-  JNIEXPORT void JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_loadTrustedSetup__Ljava_lang_String_2(JNIEnv *, jclass, jstring);
+  JNIEXPORT jlong JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_loadTrustedSetupFile(JNIEnv *, jclass, jstring);
 
   /*
    * Class:     ethereum_ckzg4844_CKZG4844JNI
-   * Method:    loadTrustedSetup
-   * Signature: ([BJ[BJ)V
+   * Method:    loadTrustedSetupBytes
+   * Signature: ([BJ[BJ)J
    */
-  JNIEXPORT void JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_loadTrustedSetup___3BJ_3BJ(JNIEnv *, jclass, jbyteArray, jlong, jbyteArray, jlong);
+  JNIEXPORT jlong JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_loadTrustedSetupBytes(JNIEnv *, jclass, jbyteArray, jlong, jbyteArray, jlong);
 
   /*
    * Class:     ethereum_ckzg4844_CKZG4844JNI
    * Method:    freeTrustedSetup
-   * Signature: ()V
+   * Signature: (J)V
    */
-  JNIEXPORT void JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_freeTrustedSetup(JNIEnv *, jclass);
+  JNIEXPORT void JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_freeTrustedSetup(JNIEnv *, jclass, jlong);
 
   /*
    * Class:     ethereum_ckzg4844_CKZG4844JNI
    * Method:    computeKzgProof
-   * Signature: ([B[B)[B
+   * Signature: (J[B[B)[B
    */
-  JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_computeKzgProof(JNIEnv *, jclass, jbyteArray, jbyteArray);
+  JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_computeKzgProof(JNIEnv *, jclass, jlong, jbyteArray, jbyteArray);
+
+  /*
+   * Class:     ethereum_ckzg4844_CKZG4844JNI
+   * Method:    computeKzgProofDirect
+   * Signature: (JLjava/nio/ByteBuffer;II[B)[B
+   */
+  JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_computeKzgProofDirect(JNIEnv *, jclass, jlong, jobject, jint, jint, jbyteArray);
 
   /*
    * Class:     ethereum_ckzg4844_CKZG4844JNI
    * Method:    computeAggregateKzgProof
-   * Signature: ([BJ)[B
+   * Signature: (J[BJ)[B
+   */
+  JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_computeAggregateKzgProof(JNIEnv *, jclass, jlong, jbyteArray, jlong);
+
+  /*
+   * Class:     ethereum_ckzg4844_CKZG4844JNI
+   * Method:    computeAggregateKzgProofDirect
+   * Signature: (JLjava/nio/ByteBuffer;IIJ)[B
    */
-  JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_computeAggregateKzgProof(JNIEnv *, jclass, jbyteArray, jlong);
+  JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_computeAggregateKzgProofDirect(JNIEnv *, jclass, jlong, jobject, jint, jint, jlong);
 
   /*
    * Class:     ethereum_ckzg4844_CKZG4844JNI
    * Method:    verifyAggregateKzgProof
-   * Signature: ([B[BJ[B)Z
+   * Signature: (J[B[BJ[B)Z
    */
-  JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_verifyAggregateKzgProof(JNIEnv *, jclass, jbyteArray, jbyteArray, jlong, jbyteArray);
+  JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_verifyAggregateKzgProof(JNIEnv *, jclass, jlong, jbyteArray, jbyteArray, jlong, jbyteArray);
+
+  /*
+   * Class:     ethereum_ckzg4844_CKZG4844JNI
+   * Method:    verifyAggregateKzgProofDirect
+   * Signature: (JLjava/nio/ByteBuffer;IILjava/nio/ByteBuffer;IIJ[B)Z
+   */
+  JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_verifyAggregateKzgProofDirect(JNIEnv *, jclass, jlong, jobject, jint, jint, jobject, jint, jint, jlong, jbyteArray);
 
   /*
    * Class:     ethereum_ckzg4844_CKZG4844JNI
    * Method:    blobToKzgCommitment
-   * Signature: ([B)[B
+   * Signature: (J[B)[B
+   */
+  JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_blobToKzgCommitment(JNIEnv *, jclass, jlong, jbyteArray);
+
+  /*
+   * Class:     ethereum_ckzg4844_CKZG4844JNI
+   * Method:    blobToKzgCommitmentDirect
+   * Signature: (JLjava/nio/ByteBuffer;II)[B
    */
-  JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_blobToKzgCommitment(JNIEnv *, jclass, jbyteArray);
+  JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_blobToKzgCommitmentDirect(JNIEnv *, jclass, jlong, jobject, jint, jint);
 
   /*
    * Class:     ethereum_ckzg4844_CKZG4844JNI
    * Method:    verifyKzgProof
-   * Signature: ([B[B[B[B)Z
+   * Signature: (J[B[B[B[B)Z
+   */
+  JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_verifyKzgProof(JNIEnv *, jclass, jlong, jbyteArray, jbyteArray, jbyteArray, jbyteArray);
+
+  /*
+   * Class:     ethereum_ckzg4844_CKZG4844JNI
+   * Method:    noopBlobToKzgCommitment
+   * Signature: (J[B)[B
+   */
+  JNIEXPORT jbyteArray JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_noopBlobToKzgCommitment(JNIEnv *, jclass, jlong, jbyteArray);
+
+  /*
+   * Class:     ethereum_ckzg4844_CKZG4844JNI
+   * Method:    noopVerifyAggregateKzgProof
+   * Signature: (J[B[BJ[B)Z
+   */
+  JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_noopVerifyAggregateKzgProof(JNIEnv *, jclass, jlong, jbyteArray, jbyteArray, jlong, jbyteArray);
+
+  /*
+   * Class:     ethereum_ckzg4844_CKZG4844JNI
+   * Method:    noopVerifyAggregateKzgProofDirect
+   * Signature: (JLjava/nio/ByteBuffer;IILjava/nio/ByteBuffer;IIJ[B)Z
    */
-  JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_verifyKzgProof(JNIEnv *, jclass, jbyteArray, jbyteArray, jbyteArray, jbyteArray);
+  JNIEXPORT jboolean JNICALL Java_ethereum_ckzg4844_CKZG4844JNI_noopVerifyAggregateKzgProofDirect(JNIEnv *, jclass, jlong, jobject, jint, jint, jobject, jint, jint, jlong, jbyteArray);
 
 #ifdef __cplusplus
 }
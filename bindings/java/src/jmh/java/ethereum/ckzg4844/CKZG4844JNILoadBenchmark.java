@@ -0,0 +1,50 @@
+package ethereum.ckzg4844;
+
+import java.util.concurrent.TimeUnit;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Warmup;
+
+/**
+ * The time to load a trusted setup, as on node startup or a setup reload, and free it again.
+ */
+@BenchmarkMode(Mode.SingleShotTime)
+@Fork(value = 1)
+@Warmup(iterations = 2)
+@Measurement(iterations = 10)
+@OutputTimeUnit(TimeUnit.MILLISECONDS)
+@State(Scope.Benchmark)
+public class CKZG4844JNILoadBenchmark {
+
+  private static final String TRUSTED_SETUP_FILE = "../../src/trusted_setup.txt";
+
+  static {
+    CKZG4844JNI.loadNativeLibrary();
+  }
+
+  private LoadTrustedSetupParameters parameters;
+
+  @Setup
+  public void setUp() {
+    parameters = TestUtils.createLoadTrustedSetupParameters(TRUSTED_SETUP_FILE);
+  }
+
+  @Benchmark
+  public void loadTrustedSetupFromFile() {
+    KZGContext.loadTrustedSetup(TRUSTED_SETUP_FILE).close();
+  }
+
+  @Benchmark
+  public void loadTrustedSetupFromBytes() {
+    KZGContext.loadTrustedSetup(parameters.getG1(), parameters.getG1Count(), parameters.getG2(),
+        parameters.getG2Count()).close();
+  }
+
+}
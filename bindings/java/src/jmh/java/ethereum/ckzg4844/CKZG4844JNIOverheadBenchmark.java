@@ -0,0 +1,83 @@
+package ethereum.ckzg4844;
+
+import java.nio.ByteBuffer;
+import java.util.concurrent.TimeUnit;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+import org.openjdk.jmh.annotations.Warmup;
+
+/**
+ * The cost of crossing JNI alone. Each benchmark calls a native function that takes and accesses
+ * the same arguments as its counterpart in {@link CKZG4844JNIBenchmark}, but does no crypto, so
+ * the difference between the two is the native compute time.
+ */
+@BenchmarkMode(Mode.AverageTime)
+@Fork(value = 1)
+@Warmup(iterations = 1, time = 1000, timeUnit = TimeUnit.MILLISECONDS)
+@Measurement(iterations = 5, time = 1000, timeUnit = TimeUnit.MILLISECONDS)
+@OutputTimeUnit(TimeUnit.NANOSECONDS)
+@State(Scope.Benchmark)
+public class CKZG4844JNIOverheadBenchmark {
+
+  static {
+    CKZG4844JNI.loadNativeLibrary();
+  }
+
+  @Param({"1", "4", "8", "16"})
+  private int count;
+
+  // the no-op functions only read the blob size from the setup
+  private long settings;
+  private byte[] blob;
+  private byte[] blobs;
+  private byte[] commitments;
+  private byte[] proof;
+  private ByteBuffer blobsBuffer;
+  private ByteBuffer commitmentsBuffer;
+
+  @Setup(Level.Trial)
+  public void setUp() {
+    settings = CKZG4844JNI.loadTrustedSetupFile("../../src/trusted_setup.txt");
+    final int bytesPerBlob =
+        CKZG4844JNI.getFieldElementsPerBlob(settings) * CKZG4844JNI.BYTES_PER_FIELD_ELEMENT;
+    // the no-op functions do not look at the contents, only the sizes matter
+    blob = new byte[bytesPerBlob];
+    blobs = new byte[count * bytesPerBlob];
+    commitments = new byte[count * CKZG4844JNI.BYTES_PER_COMMITMENT];
+    proof = new byte[CKZG4844JNI.BYTES_PER_PROOF];
+    blobsBuffer = ByteBuffer.allocateDirect(blobs.length).put(blobs).flip();
+    commitmentsBuffer = ByteBuffer.allocateDirect(commitments.length).put(commitments).flip();
+  }
+
+  @TearDown(Level.Trial)
+  public void tearDown() {
+    CKZG4844JNI.freeTrustedSetup(settings);
+  }
+
+  @Benchmark
+  public byte[] blobToKzgCommitment() {
+    return CKZG4844JNI.noopBlobToKzgCommitment(settings, blob);
+  }
+
+  @Benchmark
+  public boolean verifyAggregateKzgProof() {
+    return CKZG4844JNI.noopVerifyAggregateKzgProof(settings, blobs, commitments, count, proof);
+  }
+
+  @Benchmark
+  public boolean verifyAggregateKzgProofDirect() {
+    return CKZG4844JNI.noopVerifyAggregateKzgProofDirect(settings, blobsBuffer, 0,
+        blobsBuffer.remaining(), commitmentsBuffer, 0, commitmentsBuffer.remaining(), count, proof);
+  }
+
+}
@@ -0,0 +1,125 @@
+package ethereum.ckzg4844;
+
+import java.nio.ByteBuffer;
+import java.util.concurrent.TimeUnit;
+import java.util.stream.IntStream;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+import org.openjdk.jmh.annotations.Warmup;
+
+/**
+ * Operations per second of one {@link KZGContext} shared by all benchmark threads. The thread
+ * count is not fixed here so that one build can measure the scaling: run with
+ * {@code -PjmhThreads=<n>}, or use {@code make benchmark-scaling} to sweep it.
+ */
+@BenchmarkMode(Mode.Throughput)
+@Fork(value = 1)
+@Warmup(iterations = 1, time = 1000, timeUnit = TimeUnit.MILLISECONDS)
+@Measurement(iterations = 5, time = 1000, timeUnit = TimeUnit.MILLISECONDS)
+@OutputTimeUnit(TimeUnit.SECONDS)
+public class CKZG4844JNIThroughputBenchmark {
+
+  static {
+    CKZG4844JNI.loadNativeLibrary();
+  }
+
+  @State(Scope.Benchmark)
+  public static class ContextState {
+
+    private KZGContext context;
+
+    @Setup
+    public void setUp() {
+      context = KZGContext.loadTrustedSetup("../../src/trusted_setup.txt");
+    }
+
+    @TearDown
+    public void tearDown() {
+      context.close();
+    }
+  }
+
+  /**
+   * Inputs of each thread, so that threads do not share arrays.
+   */
+  @State(Scope.Thread)
+  public static class BlobsState {
+
+    @Param({"1", "4", "16"})
+    private int count;
+
+    private byte[] blob;
+    private byte[] blobs;
+    private byte[] commitments;
+    private byte[] proof;
+    private ByteBuffer blobsBuffer;
+    private ByteBuffer commitmentsBuffer;
+
+    @Setup
+    public void setUp(final ContextState state) {
+      final byte[][] blobs = new byte[count][];
+      final byte[][] commitments = new byte[count][];
+      IntStream.range(0, count).forEach(i -> {
+        blobs[i] = TestUtils.createRandomBlob(state.context.getFieldElementsPerBlob());
+        commitments[i] = state.context.blobToKzgCommitment(blobs[i]);
+      });
+      blob = blobs[0];
+      this.blobs = TestUtils.flatten(blobs);
+      this.commitments = TestUtils.flatten(commitments);
+      proof = state.context.computeAggregateKzgProof(this.blobs, count);
+      blobsBuffer = ByteBuffer.allocateDirect(this.blobs.length).put(this.blobs).flip();
+      commitmentsBuffer = ByteBuffer.allocateDirect(this.commitments.length).put(this.commitments)
+          .flip();
+    }
+  }
+
+  @State(Scope.Thread)
+  public static class VerifyKzgProofState {
+
+    private VerifyKzgProofParameters parameters;
+
+    @Setup
+    public void setUp() {
+      parameters = TestUtils.getVerifyKzgProofTestVectors().get(2);
+    }
+  }
+
+  @Benchmark
+  public byte[] blobToKzgCommitment(final ContextState context, final BlobsState state) {
+    return context.context.blobToKzgCommitment(state.blob);
+  }
+
+  @Benchmark
+  public byte[] computeAggregateKzgProof(final ContextState context, final BlobsState state) {
+    return context.context.computeAggregateKzgProof(state.blobs, state.count);
+  }
+
+  @Benchmark
+  public boolean verifyAggregateKzgProof(final ContextState context, final BlobsState state) {
+    return context.context.verifyAggregateKzgProof(state.blobs, state.commitments, state.count,
+        state.proof);
+  }
+
+  @Benchmark
+  public boolean verifyAggregateKzgProofDirect(final ContextState context,
+      final BlobsState state) {
+    return context.context.verifyAggregateKzgProof(state.blobsBuffer, state.commitmentsBuffer,
+        state.count, state.proof);
+  }
+
+  @Benchmark
+  public boolean verifyKzgProof(final ContextState context, final VerifyKzgProofState state) {
+    return context.context.verifyKzgProof(state.parameters.getCommitment(),
+        state.parameters.getZ(), state.parameters.getY(), state.parameters.getProof());
+  }
+
+}
@@ -4,6 +4,7 @@ import java.io.IOException;
 import java.io.InputStream;
 import java.io.UncheckedIOException;
 import java.math.BigInteger;
+import java.nio.ByteBuffer;
 import java.nio.file.Files;
 import java.nio.file.Path;
 import java.nio.file.StandardCopyOption;
@@ -14,14 +15,12 @@ public class CKZG4844JNI {
   private static final String PLATFORM_NATIVE_LIBRARY_NAME = System.mapLibraryName(LIBRARY_NAME);
 
   /**
-   * Loads the appropriate native library based on your platform and the selected {@link Preset}
-   *
-   * @param preset the preset
+   * Loads the native library for your platform. One library supports every {@link Preset}: the
+   * preset is selected by the trusted setup that is loaded.
    */
-  public static void loadNativeLibrary(Preset preset) {
+  public static void loadNativeLibrary() {
     String libraryResourcePath =
-        "lib/" + System.getProperty("os.arch") + "/" + preset.name().toLowerCase() + "/"
-            + PLATFORM_NATIVE_LIBRARY_NAME;
+        "lib/" + System.getProperty("os.arch") + "/" + PLATFORM_NATIVE_LIBRARY_NAME;
     InputStream libraryResource = CKZG4844JNI.class.getResourceAsStream(libraryResourcePath);
     if (libraryResource == null) {
       try {
@@ -47,6 +46,21 @@ public class CKZG4844JNI {
     }
   }
 
+  /**
+   * Loads the native library for your platform.
+   *
+   * @param preset ignored, as the same library supports every preset
+   * @deprecated use {@link #loadNativeLibrary()} and load the trusted setup of the preset
+   */
+  @Deprecated
+  public static void loadNativeLibrary(Preset preset) {
+    loadNativeLibrary();
+  }
+
+  /**
+   * The presets with a trusted setup. The field elements per blob of a preset are set by the
+   * number of G1 points in its setup.
+   */
   public enum Preset {
     MAINNET(4096), MINIMAL(4);
 
@@ -76,23 +90,35 @@ public class CKZG4844JNI {
   }
 
   /**
-   * Retrieves the compile-time configured FIELD_ELEMENTS_PER_BLOB. The value will be based on the
-   * selected {@link Preset} when loading the native library.
+   * Retrieves the field elements per blob of the loaded trusted setup. The value will be based on
+   * the {@link Preset} of the setup.
    *
    * @return the field elements per blob
+   * @throws RuntimeException if no trusted setup has been loaded
    */
-  public static native int getFieldElementsPerBlob();
+  public static int getFieldElementsPerBlob() {
+    return getDefaultContext().getFieldElementsPerBlob();
+  }
+
+  /**
+   * The context behind the static methods, or null when no trusted setup has been loaded.
+   */
+  private static volatile KZGContext defaultContext;
 
   /**
    * Loads the trusted setup from a file. Once loaded, the same setup will be used for all the
-   * crypto native calls. To load a new setup, free the current one by calling
+   * static crypto methods. To load a new setup, free the current one by calling
    * {@link #freeTrustedSetup()} and then load the new one. If no trusted setup has been loaded, all
-   * the crypto native calls will throw a {@link RuntimeException}.
+   * the static crypto methods will throw a {@link RuntimeException}. To use several setups, or to
+   * replace one while it is in use, create {@link KZGContext} instances instead.
    *
    * @param file a path to a trusted setup file
    * @throws CKZGException if there is a crypto error
    */
-  public static native void loadTrustedSetup(String file);
+  public static synchronized void loadTrustedSetup(String file) {
+    checkNotLoaded();
+    defaultContext = KZGContext.loadTrustedSetup(file);
+  }
 
   /**
    * An alternative to {@link #loadTrustedSetup(String)}. Loads the trusted setup from method
@@ -104,14 +130,21 @@ public class CKZG4844JNI {
    * @param g2Count the count of the g2 values
    * @throws CKZGException if there is a crypto error
    */
-  public static native void loadTrustedSetup(byte[] g1, long g1Count, byte[] g2,
-      long g2Count);
+  public static synchronized void loadTrustedSetup(byte[] g1, long g1Count, byte[] g2,
+      long g2Count) {
+    checkNotLoaded();
+    defaultContext = KZGContext.loadTrustedSetup(g1, g1Count, g2, g2Count);
+  }
 
   /**
    * Free the current trusted setup. This method will throw an exception if no trusted setup has
-   * been loaded.
+   * been loaded. Calls that are in progress finish with the setup before it is freed.
    */
-  public static native void freeTrustedSetup();
+  public static synchronized void freeTrustedSetup() {
+    final KZGContext context = getDefaultContext();
+    defaultContext = null;
+    context.close();
+  }
 
   /**
    * Compute proof at point z for the polynomial represented by blob.
@@ -121,7 +154,22 @@ public class CKZG4844JNI {
    * @return the proof
    * @throws CKZGException if there is a crypto error
    */
-  public static native byte[] computeKzgProof(byte[] blob, byte[] z_bytes);
+  public static byte[] computeKzgProof(byte[] blob, byte[] z_bytes) {
+    return getDefaultContext().computeKzgProof(blob, z_bytes);
+  }
+
+  /**
+   * Like {@link #computeKzgProof(byte[], byte[])}, but reads the blob in place from the remaining
+   * bytes of a direct buffer.
+   *
+   * @param blob    a direct buffer with the blob bytes between its position and limit
+   * @param z_bytes a point
+   * @return the proof
+   * @throws CKZGException if there is a crypto error
+   */
+  public static byte[] computeKzgProof(ByteBuffer blob, byte[] z_bytes) {
+    return getDefaultContext().computeKzgProof(blob, z_bytes);
+  }
 
   /**
    * Calculates aggregated proof for the given blobs
@@ -131,20 +179,55 @@ public class CKZG4844JNI {
    * @return the aggregated proof
    * @throws CKZGException if there is a crypto error
    */
-  public static native byte[] computeAggregateKzgProof(byte[] blobs, long count);
+  public static byte[] computeAggregateKzgProof(byte[] blobs, long count) {
+    return getDefaultContext().computeAggregateKzgProof(blobs, count);
+  }
+
+  /**
+   * Like {@link #computeAggregateKzgProof(byte[], long)}, but reads the blobs in place from the
+   * remaining bytes of a direct buffer.
+   *
+   * @param blobs a direct buffer with the flattened blobs between its position and limit
+   * @param count the count of the blobs
+   * @return the aggregated proof
+   * @throws CKZGException if there is a crypto error
+   */
+  public static byte[] computeAggregateKzgProof(ByteBuffer blobs, long count) {
+    return getDefaultContext().computeAggregateKzgProof(blobs, count);
+  }
 
   /**
    * Verify aggregated proof and commitments for the given blobs
    *
-   * @param blobs               blobs as flattened bytes
-   * @param commitments_bytes   commitments as flattened bytes
-   * @param count               the count of the blobs (should be same as the count of the commitments)
-   * @param proof_bytes         the proof that needs verifying
+   * @param blobs                  blobs as flattened bytes
+   * @param commitments_bytes      commitments as flattened bytes
+   * @param count                  the count of the blobs (should be same as the count of the commitments)
+   * @param aggregated_proof_bytes the proof that needs verifying
+   * @return true if the proof is valid and false otherwise
+   * @throws CKZGException if there is a crypto error
+   */
+  public static boolean verifyAggregateKzgProof(byte[] blobs, byte[] commitments_bytes, long count,
+      byte[] aggregated_proof_bytes) {
+    return getDefaultContext().verifyAggregateKzgProof(blobs, commitments_bytes, count,
+        aggregated_proof_bytes);
+  }
+
+  /**
+   * Like {@link #verifyAggregateKzgProof(byte[], byte[], long, byte[])}, but reads the blobs and
+   * commitments in place from the remaining bytes of direct buffers.
+   *
+   * @param blobs                  a direct buffer with the flattened blobs
+   * @param commitments_bytes      a direct buffer with the flattened commitments
+   * @param count                  the count of the blobs (should be same as the count of the commitments)
+   * @param aggregated_proof_bytes the proof that needs verifying
    * @return true if the proof is valid and false otherwise
    * @throws CKZGException if there is a crypto error
    */
-  public static native boolean verifyAggregateKzgProof(byte[] blobs, byte[] commitments_bytes, long count,
-                                                       byte[] aggregated_proof_bytes);
+  public static boolean verifyAggregateKzgProof(ByteBuffer blobs, ByteBuffer commitments_bytes,
+      long count, byte[] aggregated_proof_bytes) {
+    return getDefaultContext().verifyAggregateKzgProof(blobs, commitments_bytes, count,
+        aggregated_proof_bytes);
+  }
 
   /**
    * Calculates commitment for a given blob
@@ -153,7 +236,21 @@ public class CKZG4844JNI {
    * @return the commitment
    * @throws CKZGException if there is a crypto error
    */
-  public static native byte[] blobToKzgCommitment(byte[] blob);
+  public static byte[] blobToKzgCommitment(byte[] blob) {
+    return getDefaultContext().blobToKzgCommitment(blob);
+  }
+
+  /**
+   * Like {@link #blobToKzgCommitment(byte[])}, but reads the blob in place from the remaining
+   * bytes of a direct buffer.
+   *
+   * @param blob a direct buffer with the blob bytes between its position and limit
+   * @return the commitment
+   * @throws CKZGException if there is a crypto error
+   */
+  public static byte[] blobToKzgCommitment(ByteBuffer blob) {
+    return getDefaultContext().blobToKzgCommitment(blob);
+  }
 
   /**
    * Verify the proof by point evaluation for the given commitment
@@ -165,7 +262,75 @@ public class CKZG4844JNI {
    * @return true if the proof is valid and false otherwise
    * @throws CKZGException if there is a crypto error
    */
-  public static native boolean verifyKzgProof(byte[] commitment_bytes, byte[] z_bytes, byte[] y_bytes,
-                                              byte[] proof_bytes);
+  public static boolean verifyKzgProof(byte[] commitment_bytes, byte[] z_bytes, byte[] y_bytes,
+      byte[] proof_bytes) {
+    return getDefaultContext().verifyKzgProof(commitment_bytes, z_bytes, y_bytes, proof_bytes);
+  }
+
+  private static KZGContext getDefaultContext() {
+    final KZGContext context = defaultContext;
+    if (context == null) {
+      throw new RuntimeException(KZGContext.TRUSTED_SETUP_NOT_LOADED);
+    }
+    return context;
+  }
+
+  private static void checkNotLoaded() {
+    if (defaultContext != null) {
+      throw new RuntimeException(
+          "Trusted Setup is already loaded. Free it before loading a new one.");
+    }
+  }
+
+  /*
+   * The native functions, used by KZGContext. Each takes the handle of the settings it runs with.
+   */
+
+  static native int getFieldElementsPerBlob(long settings);
+
+  static native long loadTrustedSetupFile(String file);
+
+  static native long loadTrustedSetupBytes(byte[] g1, long g1Count, byte[] g2, long g2Count);
+
+  static native void freeTrustedSetup(long settings);
+
+  static native byte[] computeKzgProof(long settings, byte[] blob, byte[] z_bytes);
+
+  static native byte[] computeKzgProofDirect(long settings, ByteBuffer blob, int blobOffset,
+      int blobLength, byte[] z_bytes);
+
+  static native byte[] computeAggregateKzgProof(long settings, byte[] blobs, long count);
+
+  static native byte[] computeAggregateKzgProofDirect(long settings, ByteBuffer blobs,
+      int blobsOffset, int blobsLength, long count);
+
+  static native boolean verifyAggregateKzgProof(long settings, byte[] blobs,
+      byte[] commitments_bytes, long count, byte[] aggregated_proof_bytes);
+
+  static native boolean verifyAggregateKzgProofDirect(long settings, ByteBuffer blobs,
+      int blobsOffset, int blobsLength, ByteBuffer commitments_bytes, int commitmentsOffset,
+      int commitmentsLength, long count, byte[] aggregated_proof_bytes);
+
+  static native byte[] blobToKzgCommitment(long settings, byte[] blob);
+
+  static native byte[] blobToKzgCommitmentDirect(long settings, ByteBuffer blob, int blobOffset,
+      int blobLength);
+
+  static native boolean verifyKzgProof(long settings, byte[] commitment_bytes, byte[] z_bytes,
+      byte[] y_bytes, byte[] proof_bytes);
+
+  /*
+   * Take the same arguments as their counterparts and access them the same way, but skip the
+   * crypto, so that benchmarks can tell the cost of crossing JNI from the cost of the computation.
+   */
+
+  static native byte[] noopBlobToKzgCommitment(long settings, byte[] blob);
+
+  static native boolean noopVerifyAggregateKzgProof(long settings, byte[] blobs,
+      byte[] commitments_bytes, long count, byte[] aggregated_proof_bytes);
+
+  static native boolean noopVerifyAggregateKzgProofDirect(long settings, ByteBuffer blobs,
+      int blobsOffset, int blobsLength, ByteBuffer commitments_bytes, int commitmentsOffset,
+      int commitmentsLength, long count, byte[] aggregated_proof_bytes);
 
 }
@@ -0,0 +1,356 @@
+package ethereum.ckzg4844;
+
+import java.nio.ByteBuffer;
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.concurrent.atomic.AtomicReference;
+
+/**
+ * A loaded trusted setup and the crypto methods that use it.
+ *
+ * <p>Contexts are independent, so one JVM can hold several setups, e.g. a mainnet and a minimal
+ * one. All methods are thread-safe. Each call holds a reference to the setup it started with, so
+ * {@link #reloadTrustedSetup(String)} can replace the setup while other threads are verifying, and
+ * {@link #close()} can be called at any time: the native memory of a setup is freed once the last
+ * call using it has returned.
+ */
+public final class KZGContext implements AutoCloseable {
+
+  static final String TRUSTED_SETUP_NOT_LOADED = "Trusted Setup is not loaded.";
+
+  private final AtomicReference<Settings> settings;
+
+  private KZGContext(long handle) {
+    this.settings = new AtomicReference<>(new Settings(handle));
+  }
+
+  /**
+   * Loads a trusted setup from a file into a new context.
+   *
+   * @param file a path to a trusted setup file
+   * @return the context, to be closed after use
+   * @throws CKZGException if there is a crypto error
+   */
+  public static KZGContext loadTrustedSetup(String file) {
+    return new KZGContext(CKZG4844JNI.loadTrustedSetupFile(file));
+  }
+
+  /**
+   * An alternative to {@link #loadTrustedSetup(String)}. Loads the trusted setup from method
+   * parameters instead of a file.
+   *
+   * @param g1      g1 values as bytes
+   * @param g1Count the count of the g1 values
+   * @param g2      g2 values as bytes
+   * @param g2Count the count of the g2 values
+   * @return the context, to be closed after use
+   * @throws CKZGException if there is a crypto error
+   */
+  public static KZGContext loadTrustedSetup(byte[] g1, long g1Count, byte[] g2, long g2Count) {
+    return new KZGContext(CKZG4844JNI.loadTrustedSetupBytes(g1, g1Count, g2, g2Count));
+  }
+
+  /**
+   * Replaces the setup of this context with one loaded from a file. Calls that start afterwards
+   * use the new setup; calls in progress finish with the old one, which is then freed. Nothing
+   * waits for them.
+   *
+   * @param file a path to a trusted setup file
+   * @throws CKZGException if there is a crypto error, in which case the old setup stays in use
+   */
+  public void reloadTrustedSetup(String file) {
+    replace(CKZG4844JNI.loadTrustedSetupFile(file));
+  }
+
+  /**
+   * Like {@link #reloadTrustedSetup(String)}, but loads the setup from method parameters.
+   *
+   * @param g1      g1 values as bytes
+   * @param g1Count the count of the g1 values
+   * @param g2      g2 values as bytes
+   * @param g2Count the count of the g2 values
+   * @throws CKZGException if there is a crypto error, in which case the old setup stays in use
+   */
+  public void reloadTrustedSetup(byte[] g1, long g1Count, byte[] g2, long g2Count) {
+    replace(CKZG4844JNI.loadTrustedSetupBytes(g1, g1Count, g2, g2Count));
+  }
+
+  /**
+   * Releases the setup. Calls in progress finish first; later calls throw a
+   * {@link RuntimeException}. Closing twice has no effect.
+   */
+  @Override
+  public void close() {
+    final Settings old = settings.getAndSet(null);
+    if (old != null) {
+      old.release();
+    }
+  }
+
+  /**
+   * Retrieves the field elements per blob of the setup, which sets the size of the blobs that the
+   * crypto methods accept.
+   *
+   * @return the field elements per blob
+   */
+  public int getFieldElementsPerBlob() {
+    final Settings s = acquire();
+    try {
+      return CKZG4844JNI.getFieldElementsPerBlob(s.handle);
+    } finally {
+      s.release();
+    }
+  }
+
+  /**
+   * Calculates the bytes per blob based on the output from {@link #getFieldElementsPerBlob()}
+   *
+   * @return the bytes per blob
+   */
+  public int getBytesPerBlob() {
+    return getFieldElementsPerBlob() * CKZG4844JNI.BYTES_PER_FIELD_ELEMENT;
+  }
+
+  /**
+   * Compute proof at point z for the polynomial represented by blob.
+   *
+   * @param blob blob bytes
+   * @param z_bytes a point
+   * @return the proof
+   * @throws CKZGException if there is a crypto error
+   */
+  public byte[] computeKzgProof(byte[] blob, byte[] z_bytes) {
+    final Settings s = acquire();
+    try {
+      return CKZG4844JNI.computeKzgProof(s.handle, blob, z_bytes);
+    } finally {
+      s.release();
+    }
+  }
+
+  /**
+   * Like {@link #computeKzgProof(byte[], byte[])}, but reads the blob in place from the remaining
+   * bytes of a direct buffer.
+   *
+   * @param blob    a direct buffer with the blob bytes between its position and limit
+   * @param z_bytes a point
+   * @return the proof
+   * @throws CKZGException if there is a crypto error
+   */
+  public byte[] computeKzgProof(ByteBuffer blob, byte[] z_bytes) {
+    checkDirect(blob);
+    final Settings s = acquire();
+    try {
+      return CKZG4844JNI.computeKzgProofDirect(s.handle, blob, blob.position(), blob.remaining(),
+          z_bytes);
+    } finally {
+      s.release();
+    }
+  }
+
+  /**
+   * Calculates aggregated proof for the given blobs
+   *
+   * @param blobs blobs as flattened bytes
+   * @param count the count of the blobs
+   * @return the aggregated proof
+   * @throws CKZGException if there is a crypto error
+   */
+  public byte[] computeAggregateKzgProof(byte[] blobs, long count) {
+    final Settings s = acquire();
+    try {
+      return CKZG4844JNI.computeAggregateKzgProof(s.handle, blobs, count);
+    } finally {
+      s.release();
+    }
+  }
+
+  /**
+   * Like {@link #computeAggregateKzgProof(byte[], long)}, but reads the blobs in place from the
+   * remaining bytes of a direct buffer.
+   *
+   * @param blobs a direct buffer with the flattened blobs between its position and limit
+   * @param count the count of the blobs
+   * @return the aggregated proof
+   * @throws CKZGException if there is a crypto error
+   */
+  public byte[] computeAggregateKzgProof(ByteBuffer blobs, long count) {
+    checkDirect(blobs);
+    final Settings s = acquire();
+    try {
+      return CKZG4844JNI.computeAggregateKzgProofDirect(s.handle, blobs, blobs.position(),
+          blobs.remaining(), count);
+    } finally {
+      s.release();
+    }
+  }
+
+  /**
+   * Verify aggregated proof and commitments for the given blobs
+   *
+   * @param blobs                  blobs as flattened bytes
+   * @param commitments_bytes      commitments as flattened bytes
+   * @param count                  the count of the blobs (should be same as the count of the commitments)
+   * @param aggregated_proof_bytes the proof that needs verifying
+   * @return true if the proof is valid and false otherwise
+   * @throws CKZGException if there is a crypto error
+   */
+  public boolean verifyAggregateKzgProof(byte[] blobs, byte[] commitments_bytes, long count,
+      byte[] aggregated_proof_bytes) {
+    final Settings s = acquire();
+    try {
+      return CKZG4844JNI.verifyAggregateKzgProof(s.handle, blobs, commitments_bytes, count,
+          aggregated_proof_bytes);
+    } finally {
+      s.release();
+    }
+  }
+
+  /**
+   * Like {@link #verifyAggregateKzgProof(byte[], byte[], long, byte[])}, but reads the blobs and
+   * commitments in place from the remaining bytes of direct buffers.
+   *
+   * @param blobs                  a direct buffer with the flattened blobs
+   * @param commitments_bytes      a direct buffer with the flattened commitments
+   * @param count                  the count of the blobs (should be same as the count of the commitments)
+   * @param aggregated_proof_bytes the proof that needs verifying
+   * @return true if the proof is valid and false otherwise
+   * @throws CKZGException if there is a crypto error
+   */
+  public boolean verifyAggregateKzgProof(ByteBuffer blobs, ByteBuffer commitments_bytes,
+      long count, byte[] aggregated_proof_bytes) {
+    checkDirect(blobs);
+    checkDirect(commitments_bytes);
+    final Settings s = acquire();
+    try {
+      return CKZG4844JNI.verifyAggregateKzgProofDirect(s.handle, blobs, blobs.position(),
+          blobs.remaining(), commitments_bytes, commitments_bytes.position(),
+          commitments_bytes.remaining(), count, aggregated_proof_bytes);
+    } finally {
+      s.release();
+    }
+  }
+
+  /**
+   * Calculates commitment for a given blob
+   *
+   * @param blob blob bytes
+   * @return the commitment
+   * @throws CKZGException if there is a crypto error
+   */
+  public byte[] blobToKzgCommitment(byte[] blob) {
+    final Settings s = acquire();
+    try {
+      return CKZG4844JNI.blobToKzgCommitment(s.handle, blob);
+    } finally {
+      s.release();
+    }
+  }
+
+  /**
+   * Like {@link #blobToKzgCommitment(byte[])}, but reads the blob in place from the remaining
+   * bytes of a direct buffer.
+   *
+   * @param blob a direct buffer with the blob bytes between its position and limit
+   * @return the commitment
+   * @throws CKZGException if there is a crypto error
+   */
+  public byte[] blobToKzgCommitment(ByteBuffer blob) {
+    checkDirect(blob);
+    final Settings s = acquire();
+    try {
+      return CKZG4844JNI.blobToKzgCommitmentDirect(s.handle, blob, blob.position(),
+          blob.remaining());
+    } finally {
+      s.release();
+    }
+  }
+
+  /**
+   * Verify the proof by point evaluation for the given commitment
+   *
+   * @param commitment_bytes  commitment bytes
+   * @param z_bytes           Z
+   * @param y_bytes           Y
+   * @param proof_bytes       the proof that needs verifying
+   * @return true if the proof is valid and false otherwise
+   * @throws CKZGException if there is a crypto error
+   */
+  public boolean verifyKzgProof(byte[] commitment_bytes, byte[] z_bytes, byte[] y_bytes,
+      byte[] proof_bytes) {
+    final Settings s = acquire();
+    try {
+      return CKZG4844JNI.verifyKzgProof(s.handle, commitment_bytes, z_bytes, y_bytes,
+          proof_bytes);
+    } finally {
+      s.release();
+    }
+  }
+
+  /**
+   * Takes a reference to the current setup, retrying if it is replaced concurrently.
+   */
+  private Settings acquire() {
+    while (true) {
+      final Settings s = settings.get();
+      if (s == null) {
+        throw new RuntimeException(TRUSTED_SETUP_NOT_LOADED);
+      }
+      if (s.retain()) {
+        return s;
+      }
+    }
+  }
+
+  private void replace(long handle) {
+    final Settings next = new Settings(handle);
+    Settings old;
+    do {
+      old = settings.get();
+      if (old == null) {
+        next.release();
+        throw new RuntimeException(TRUSTED_SETUP_NOT_LOADED);
+      }
+    } while (!settings.compareAndSet(old, next));
+    old.release();
+  }
+
+  private static void checkDirect(ByteBuffer buffer) {
+    if (!buffer.isDirect()) {
+      throw new IllegalArgumentException(
+          "Expected a direct buffer. Use the byte[] overload for heap buffers.");
+    }
+  }
+
+  /**
+   * A native setup and the number of references to it: one from the context while it is current,
+   * and one from each call in progress. It is freed when the count drops to zero, after which it
+   * can no longer be retained.
+   */
+  private static final class Settings {
+
+    private final long handle;
+    private final AtomicInteger references = new AtomicInteger(1);
+
+    private Settings(long handle) {
+      this.handle = handle;
+    }
+
+    private boolean retain() {
+      int count;
+      do {
+        count = references.get();
+        if (count == 0) {
+          return false;
+        }
+      } while (!references.compareAndSet(count, count + 1));
+      return true;
+    }
+
+    private void release() {
+      if (references.decrementAndGet() == 0) {
+        CKZG4844JNI.freeTrustedSetup(handle);
+      }
+    }
+  }
+
+}
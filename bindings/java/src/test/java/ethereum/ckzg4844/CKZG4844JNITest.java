@@ -1,5 +1,6 @@
 package ethereum.ckzg4844;
 
+import static org.junit.jupiter.api.Assertions.assertArrayEquals;
 import static org.junit.jupiter.api.Assertions.assertEquals;
 import static org.junit.jupiter.api.Assertions.assertFalse;
 import static org.junit.jupiter.api.Assertions.assertThrows;
@@ -7,8 +8,18 @@ import static org.junit.jupiter.api.Assertions.assertTrue;
 
 import ethereum.ckzg4844.CKZG4844JNI.Preset;
 import ethereum.ckzg4844.CKZGException.CKZGError;
+import java.nio.ByteBuffer;
+import java.util.Arrays;
+import java.util.List;
 import java.util.Map;
 import java.util.Optional;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicBoolean;
+import java.util.stream.Collectors;
 import java.util.stream.IntStream;
 import java.util.stream.Stream;
 import org.junit.jupiter.api.Test;
@@ -26,14 +37,41 @@ public class CKZG4844JNITest {
   static {
     PRESET = Optional.ofNullable(System.getenv("PRESET")).map(String::toUpperCase)
         .map(Preset::valueOf).orElse(Preset.MAINNET);
-    CKZG4844JNI.loadNativeLibrary(PRESET);
+    CKZG4844JNI.loadNativeLibrary();
   }
 
   @Test
-  public void getsTheConfiguredFieldElementsPerBlob() {
+  public void getsTheFieldElementsPerBlobOfTheLoadedSetup() {
+    loadTrustedSetup();
     assertEquals(PRESET.fieldElementsPerBlob, CKZG4844JNI.getFieldElementsPerBlob());
     assertEquals(PRESET.fieldElementsPerBlob * CKZG4844JNI.BYTES_PER_FIELD_ELEMENT,
         CKZG4844JNI.getBytesPerBlob());
+    CKZG4844JNI.freeTrustedSetup();
+  }
+
+  @Test
+  public void loadsTheSetupsOfEveryPresetSideBySide() {
+    try (final KZGContext mainnet = KZGContext.loadTrustedSetup(
+        TRUSTED_SETUP_FILE_BY_PRESET.get(Preset.MAINNET));
+        final KZGContext minimal = KZGContext.loadTrustedSetup(
+            TRUSTED_SETUP_FILE_BY_PRESET.get(Preset.MINIMAL))) {
+      assertEquals(Preset.MAINNET.fieldElementsPerBlob, mainnet.getFieldElementsPerBlob());
+      assertEquals(Preset.MINIMAL.fieldElementsPerBlob, minimal.getFieldElementsPerBlob());
+
+      final byte[] blobs = TestUtils.flatten(
+          TestUtils.createRandomBlob(Preset.MINIMAL.fieldElementsPerBlob),
+          TestUtils.createRandomBlob(Preset.MINIMAL.fieldElementsPerBlob));
+      final byte[] commitments = TestUtils.flatten(
+          minimal.blobToKzgCommitment(Arrays.copyOf(blobs, minimal.getBytesPerBlob())),
+          minimal.blobToKzgCommitment(
+              Arrays.copyOfRange(blobs, minimal.getBytesPerBlob(), blobs.length)));
+      final byte[] proof = minimal.computeAggregateKzgProof(blobs, 2);
+      assertTrue(minimal.verifyAggregateKzgProof(blobs, commitments, 2, proof));
+
+      final CKZGException exception = assertThrows(CKZGException.class,
+          () -> mainnet.computeAggregateKzgProof(blobs, 2));
+      assertEquals(CKZGError.C_KZG_BADARGS, exception.getError());
+    }
   }
 
   @ParameterizedTest
@@ -74,6 +112,128 @@ public class CKZG4844JNITest {
 
   }
 
+  @Test
+  public void computesAndVerifiesProofsFromDirectBuffers() {
+
+    loadTrustedSetup();
+
+    final int count = 3;
+    final byte[] blobs = TestUtils.createRandomBlobs(count);
+    final byte[] commitments = TestUtils.flatten(
+        IntStream.range(0, count).mapToObj(i -> CKZG4844JNI.blobToKzgCommitment(
+            Arrays.copyOfRange(blobs, i * CKZG4844JNI.getBytesPerBlob(),
+                (i + 1) * CKZG4844JNI.getBytesPerBlob()))).toArray(byte[][]::new));
+    final byte[] proof = CKZG4844JNI.computeAggregateKzgProof(blobs, count);
+
+    // the blobs start after a gap to check that the position is respected
+    final ByteBuffer blobsBuffer = ByteBuffer.allocateDirect(blobs.length + 7);
+    blobsBuffer.position(7);
+    blobsBuffer.put(blobs).flip().position(7);
+    final ByteBuffer commitmentsBuffer = ByteBuffer.allocateDirect(commitments.length);
+    commitmentsBuffer.put(commitments).flip();
+
+    final ByteBuffer firstBlob = blobsBuffer.slice().limit(CKZG4844JNI.getBytesPerBlob());
+    assertArrayEquals(Arrays.copyOf(commitments, CKZG4844JNI.BYTES_PER_COMMITMENT),
+        CKZG4844JNI.blobToKzgCommitment(firstBlob));
+    assertArrayEquals(proof, CKZG4844JNI.computeAggregateKzgProof(blobsBuffer, count));
+    assertTrue(CKZG4844JNI.verifyAggregateKzgProof(blobsBuffer, commitmentsBuffer, count, proof));
+    assertFalse(CKZG4844JNI.verifyAggregateKzgProof(blobsBuffer, commitmentsBuffer, count,
+        TestUtils.createRandomProof(count)));
+
+    final byte[] z = TestUtils.randomBLSFieldElementBytes();
+    assertArrayEquals(CKZG4844JNI.computeKzgProof(Arrays.copyOf(blobs,
+        CKZG4844JNI.getBytesPerBlob()), z), CKZG4844JNI.computeKzgProof(firstBlob, z));
+
+    assertThrows(IllegalArgumentException.class,
+        () -> CKZG4844JNI.blobToKzgCommitment(ByteBuffer.wrap(blobs)));
+
+    final CKZGException exception = assertThrows(CKZGException.class,
+        () -> CKZG4844JNI.computeAggregateKzgProof(blobsBuffer, count + 1));
+    assertEquals(CKZGError.C_KZG_BADARGS, exception.getError());
+
+    CKZG4844JNI.freeTrustedSetup();
+  }
+
+  @Test
+  public void contextsAreIndependentOfEachOtherAndOfTheStaticSetup() {
+
+    final String file = TRUSTED_SETUP_FILE_BY_PRESET.get(PRESET);
+    final byte[] blob = TestUtils.createRandomBlob(PRESET.fieldElementsPerBlob);
+
+    try (final KZGContext first = KZGContext.loadTrustedSetup(file)) {
+      final byte[] commitment = first.blobToKzgCommitment(blob);
+
+      try (final KZGContext second = KZGContext.loadTrustedSetup(file)) {
+        assertArrayEquals(commitment, second.blobToKzgCommitment(blob));
+      }
+      assertArrayEquals(commitment, first.blobToKzgCommitment(blob));
+
+      // the static methods are not affected by contexts
+      assertExceptionIsTrustedSetupIsNotLoaded(assertThrows(RuntimeException.class,
+          () -> CKZG4844JNI.blobToKzgCommitment(blob)));
+    }
+  }
+
+  @Test
+  public void throwsIfContextIsUsedAfterClose() {
+
+    final KZGContext context = KZGContext.loadTrustedSetup(TRUSTED_SETUP_FILE_BY_PRESET.get(PRESET));
+    context.close();
+    context.close();
+
+    final byte[] blob = TestUtils.createRandomBlob(PRESET.fieldElementsPerBlob);
+    assertExceptionIsTrustedSetupIsNotLoaded(assertThrows(RuntimeException.class,
+        () -> context.blobToKzgCommitment(blob)));
+    assertExceptionIsTrustedSetupIsNotLoaded(assertThrows(RuntimeException.class,
+        () -> context.reloadTrustedSetup(TRUSTED_SETUP_FILE_BY_PRESET.get(PRESET))));
+  }
+
+  @Test
+  public void reloadsTrustedSetupWhileInUse() throws Exception {
+
+    final String file = TRUSTED_SETUP_FILE_BY_PRESET.get(PRESET);
+    final byte[] blobs = TestUtils.flatten(TestUtils.createRandomBlob(PRESET.fieldElementsPerBlob),
+        TestUtils.createRandomBlob(PRESET.fieldElementsPerBlob));
+    final LoadTrustedSetupParameters parameters = TestUtils.createLoadTrustedSetupParameters(file);
+
+    try (final KZGContext context = KZGContext.loadTrustedSetup(file)) {
+      final byte[] proof = context.computeAggregateKzgProof(blobs, 2);
+      final AtomicBoolean running = new AtomicBoolean(true);
+      // Reloading starts once every worker has completed a call
+      final CountDownLatch started = new CountDownLatch(4);
+      final ExecutorService executor = Executors.newFixedThreadPool(4);
+      final List<Future<Integer>> results = IntStream.range(0, 4)
+          .mapToObj(__ -> executor.submit(() -> {
+            int calls = 0;
+            do {
+              assertArrayEquals(proof, context.computeAggregateKzgProof(blobs, 2));
+              if (calls++ == 0) {
+                started.countDown();
+              }
+            } while (running.get());
+            return calls;
+          })).collect(Collectors.toList());
+
+      assertTrue(started.await(1, TimeUnit.MINUTES));
+      for (int i = 0; i < 10; i++) {
+        if (i % 2 == 0) {
+          context.reloadTrustedSetup(file);
+        } else {
+          context.reloadTrustedSetup(parameters.getG1(), parameters.getG1Count(),
+              parameters.getG2(), parameters.getG2Count());
+        }
+      }
+      running.set(false);
+      for (final Future<Integer> result : results) {
+        assertTrue(result.get() > 0);
+      }
+      executor.shutdown();
+
+      assertThrows(RuntimeException.class, () -> context.reloadTrustedSetup("missing.txt"));
+      assertArrayEquals(proof, context.computeAggregateKzgProof(blobs, 2));
+    }
+  }
+
   @ParameterizedTest(name = "{index}")
   @MethodSource("getVerifyKzgProofTestVectors")
   public void testVerifyKzgProof(final VerifyKzgProofParameters parameters) {
@@ -166,7 +326,8 @@ public class CKZG4844JNITest {
   public void throwsIfMethodIsUsedWithoutLoadingTrustedSetup() {
 
     final RuntimeException exception = assertThrows(RuntimeException.class,
-        () -> CKZG4844JNI.blobToKzgCommitment(TestUtils.createRandomBlob()));
+        () -> CKZG4844JNI.blobToKzgCommitment(
+            TestUtils.createRandomBlob(PRESET.fieldElementsPerBlob)));
 
     assertExceptionIsTrustedSetupIsNotLoaded(exception);
 
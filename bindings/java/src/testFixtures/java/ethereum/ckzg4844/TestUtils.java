@@ -35,7 +35,11 @@ public class TestUtils {
   }
 
   public static byte[] createRandomBlob() {
-    final byte[][] blob = IntStream.range(0, CKZG4844JNI.getFieldElementsPerBlob())
+    return createRandomBlob(CKZG4844JNI.getFieldElementsPerBlob());
+  }
+
+  public static byte[] createRandomBlob(final int fieldElementsPerBlob) {
+    final byte[][] blob = IntStream.range(0, fieldElementsPerBlob)
         .mapToObj(__ -> randomBLSFieldElement())
         .map(fieldElement -> fieldElement.toArray(ByteOrder.LITTLE_ENDIAN)).toArray(byte[][]::new);
     return flatten(blob);
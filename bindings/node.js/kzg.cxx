@@ -4,6 +4,9 @@
 #include <sstream>  // std::ostringstream
 #include <algorithm> // std::copy
 #include <iterator> // std::ostream_iterator
+#include <map>
+#include <mutex>
+#include <vector>
 #include <napi.h>
 #include "c_kzg_4844.h"
 #include "blst.h"
@@ -67,6 +70,210 @@ const uint8_t * extract_byte_array_from_param(const Napi::CallbackInfo& info, co
   return param.As<Napi::Uint8Array>().Data();
 }
 
+// Get the data of a Uint8Array value whose length is a non-zero multiple of
+// unit, or of exactly unit bytes if exact is set, without copying it
+uint8_t * extract_sized_byte_array(
+  const Napi::Env env,
+  const Napi::Value value,
+  const std::string name,
+  const size_t unit,
+  const bool exact,
+  size_t *count_out
+) {
+  if (!value.IsTypedArray() || value.As<Napi::TypedArray>().TypedArrayType() != napi_uint8_array) {
+    throw_invalid_argument_type(env, name, "UInt8Array");
+    return NULL;
+  }
+  auto param = value.As<Napi::Uint8Array>();
+  size_t length = param.ByteLength();
+  if (exact ? length != unit : length % unit != 0) {
+    Napi::RangeError::New(
+      env,
+      "Invalid length of " + name + ": " + std::to_string(length)
+      + (exact ? " bytes, expected " : " bytes, expected a multiple of ") + std::to_string(unit)
+    ).ThrowAsJavaScriptException();
+    return NULL;
+  }
+  if (count_out != NULL) {
+    *count_out = length / unit;
+  }
+  return param.Data();
+}
+
+// As extract_sized_byte_array, for the parameter at index
+uint8_t * extract_sized_byte_array_from_param(
+  const Napi::CallbackInfo& info,
+  const int index,
+  const std::string name,
+  const size_t unit,
+  const bool exact,
+  size_t *count_out
+) {
+  return extract_sized_byte_array(info.Env(), info[index], name, unit, exact, count_out);
+}
+
+// Get an Array parameter, throwing if it is anything else
+bool extract_array_from_param(const Napi::CallbackInfo& info, const int index, const std::string name, Napi::Array &out) {
+  if (!info[index].IsArray()) {
+    throw_invalid_argument_type(info.Env(), name, "UInt8Array[]");
+    return false;
+  }
+  out = info[index].As<Napi::Array>();
+  return true;
+}
+
+/*
+ * Shared trusted setups
+ *
+ * The addon is loaded once per process, while each worker_thread has its own
+ * isolate. Setups are kept in a process-wide registry keyed by file path and
+ * counted, so every isolate that loads the same file shares one copy, and it
+ * is freed when the last handle to it is released.
+ */
+
+struct SharedSetup {
+  KZGSettings settings;
+  std::string file_path;
+  size_t ref_count;
+};
+
+std::mutex shared_setups_lock;
+std::map<std::string, SharedSetup *> shared_setups;
+
+// What a SetupHandle wraps: one isolate's reference to a shared setup
+struct SetupHandle {
+  std::string file_path;
+  SharedSetup *shared;
+};
+
+// Find or load the setup for a file, and take a reference to it
+SharedSetup *acquire_shared_setup(const std::string &file_path, std::string &error) {
+  std::lock_guard<std::mutex> guard(shared_setups_lock);
+
+  auto found = shared_setups.find(file_path);
+  if (found != shared_setups.end()) {
+    found->second->ref_count++;
+    return found->second;
+  }
+
+  FILE* f = fopen(file_path.c_str(), "r");
+  if (f == NULL) {
+    error = "Error opening trusted setup file: " + file_path;
+    return NULL;
+  }
+
+  auto shared = new SharedSetup();
+  C_KZG_RET ret = load_trusted_setup_file(&shared->settings, f);
+  fclose(f);
+  if (ret != C_KZG_OK) {
+    delete shared;
+    error = "Error loading trusted setup file";
+    return NULL;
+  }
+
+  shared->file_path = file_path;
+  shared->ref_count = 1;
+  shared_setups[file_path] = shared;
+  return shared;
+}
+
+// Take another reference to a setup, for work that may outlive its handle
+SharedSetup *retain_shared_setup(SharedSetup *shared) {
+  std::lock_guard<std::mutex> guard(shared_setups_lock);
+  shared->ref_count++;
+  return shared;
+}
+
+// Drop a reference, freeing the setup if it was the last one
+void unref_shared_setup(SharedSetup *shared) {
+  std::lock_guard<std::mutex> guard(shared_setups_lock);
+  if (--shared->ref_count == 0) {
+    shared_setups.erase(shared->file_path);
+    free_trusted_setup(&shared->settings);
+    delete shared;
+  }
+}
+
+// Drop a handle's reference, after which the handle can no longer be used
+void release_shared_setup(SetupHandle *handle) {
+  if (handle->shared == NULL) {
+    return;
+  }
+  unref_shared_setup(handle->shared);
+  handle->shared = NULL;
+}
+
+// Get a handle, throwing if the value is not one
+SetupHandle *get_setup_handle(const Napi::Env env, const Napi::Value value) {
+  if (!value.IsExternal()) {
+    throw_invalid_argument_type(env, "setupHandle", "SetupHandle");
+    return NULL;
+  }
+  return value.As<Napi::External<SetupHandle>>().Data();
+}
+
+// Get the setup a handle refers to, throwing if it is not a handle or was freed
+SharedSetup *get_shared_setup(const Napi::Env env, const Napi::Value value) {
+  auto handle = get_setup_handle(env, value);
+  if (handle == NULL) {
+    return NULL;
+  }
+  if (handle->shared == NULL) {
+    Napi::Error::New(env, "The trusted setup has been freed").ThrowAsJavaScriptException();
+    return NULL;
+  }
+  return handle->shared;
+}
+
+KZGSettings *get_kzg_settings(const Napi::Env env, const Napi::Value value) {
+  auto shared = get_shared_setup(env, value);
+  return shared == NULL ? NULL : &shared->settings;
+}
+
+// The addon is built for the largest blob size, and each setup selects its
+// own, so blob sizes are checked against the setup rather than BYTES_PER_BLOB
+size_t bytes_per_blob(const KZGSettings *kzg_settings) {
+  return kzg_settings_field_elements_per_blob(kzg_settings) * BYTES_PER_FIELD_ELEMENT;
+}
+
+// Copy an array of fixed-size items into one contiguous allocation,
+// checking that each is a Uint8Array of exactly the item's size
+template <typename T>
+bool copy_items(std::vector<T> &out, Napi::Array param, const std::string name, const Napi::Env env) {
+  out.resize(param.Length());
+  for (uint32_t index = 0; index < out.size(); index++) {
+    auto bytes = extract_sized_byte_array(
+      env, param[index], name + "[" + std::to_string(index) + "]", sizeof(T), true, NULL);
+    if (bytes == NULL) {
+      return false;
+    }
+    memcpy(&out[index], bytes, sizeof(T));
+  }
+  return true;
+}
+
+// Copy an array of blobs into one allocation, packed at the blob size of the
+// setup as the library reads them, checking that each is a Uint8Array of
+// exactly that size
+bool copy_blobs(
+  std::vector<uint8_t> &out,
+  Napi::Array param,
+  const std::string name,
+  const KZGSettings *kzg_settings,
+  const Napi::Env env
+) {
+  size_t blob_size = bytes_per_blob(kzg_settings);
+  out.resize(param.Length() * blob_size);
+  for (uint32_t index = 0; index < param.Length(); index++) {
+    auto bytes = extract_sized_byte_array(
+      env, param[index], name + "[" + std::to_string(index) + "]", blob_size, true, NULL);
+    if (bytes == NULL) {
+      return false;
+    }
+    memcpy(&out[index * blob_size], bytes, blob_size);
+  }
+  return true;
+}
 
 // loadTrustedSetup: (filePath: string) => SetupHandle;
 Napi::Value LoadTrustedSetup(const Napi::CallbackInfo& info) {
@@ -84,32 +291,62 @@ Napi::Value LoadTrustedSetup(const Napi::CallbackInfo& info) {
 
   const std::string file_path = info[0].ToString().Utf8Value();
 
-  KZGSettings* kzg_settings = (KZGSettings*)malloc(sizeof(KZGSettings));
-
-  if (kzg_settings == NULL) {
-    Napi::Error::New(env, "Error while allocating memory for KZG settings").ThrowAsJavaScriptException();
+  std::string error;
+  SharedSetup *shared = acquire_shared_setup(file_path, error);
+  if (shared == NULL) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
     return env.Null();
-  };
+  }
 
-  FILE* f = fopen(file_path.c_str(), "r");
+  // A handle that is collected, e.g. when its worker exits, releases its reference
+  return Napi::External<SetupHandle>::New(
+    env,
+    new SetupHandle{file_path, shared},
+    [](Napi::Env /*env*/, SetupHandle *handle) {
+      release_shared_setup(handle);
+      delete handle;
+    }
+  );
+}
 
-  if (f == NULL) {
-    free(kzg_settings);
-    Napi::Error::New(env, "Error opening trusted setup file: " + file_path).ThrowAsJavaScriptException();
-    return env.Null();
+// freeTrustedSetup: (setupHandle: SetupHandle) => void;
+Napi::Value FreeTrustedSetup(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  size_t argument_count = info.Length();
+  size_t expected_argument_count = 1;
+  if (argument_count != expected_argument_count) {
+    return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
   }
 
-  if (load_trusted_setup_file(kzg_settings, f) != C_KZG_OK) {
-    free(kzg_settings);
-    Napi::Error::New(env, "Error loading trusted setup file").ThrowAsJavaScriptException();
+  auto handle = get_setup_handle(env, info[0]);
+  if (handle == NULL) {
     return env.Null();
   }
+  release_shared_setup(handle);
+  return env.Undefined();
+}
 
-  return Napi::External<KZGSettings>::New(info.Env(), kzg_settings);
+// trustedSetupRefCount: (setupHandle: SetupHandle) => number;
+Napi::Value TrustedSetupRefCount(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  size_t argument_count = info.Length();
+  size_t expected_argument_count = 1;
+  if (argument_count != expected_argument_count) {
+    return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
+  }
+
+  auto handle = get_setup_handle(env, info[0]);
+  if (handle == NULL) {
+    return env.Null();
+  }
+  std::lock_guard<std::mutex> guard(shared_setups_lock);
+  return Napi::Number::New(env, handle->shared == NULL ? 0 : handle->shared->ref_count);
 }
 
-// freeTrustedSetup: (setupHandle: SetupHandle) => void;
-Napi::Value FreeTrustedSetup(const Napi::CallbackInfo& info) {
+// fieldElementsPerBlob: (setupHandle: SetupHandle) => number;
+Napi::Value FieldElementsPerBlob(const Napi::CallbackInfo& info) {
   auto env = info.Env();
 
   size_t argument_count = info.Length();
@@ -118,10 +355,12 @@ Napi::Value FreeTrustedSetup(const Napi::CallbackInfo& info) {
     return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
   }
 
-  auto kzg_settings = info[0].As<Napi::External<KZGSettings>>().Data();
-  free_trusted_setup(kzg_settings);
-  free(kzg_settings);
-  return env.Undefined();
+  auto kzg_settings = get_kzg_settings(env, info[0]);
+  if (kzg_settings == NULL) {
+    return env.Null();
+  }
+
+  return Napi::Number::New(env, kzg_settings_field_elements_per_blob(kzg_settings));
 }
 
 // blobToKzgCommitment: (blob: Blob, setupHandle: SetupHandle) => KZGCommitment;
@@ -134,12 +373,16 @@ Napi::Value BlobToKzgCommitment(const Napi::CallbackInfo& info) {
     return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
   }
 
-  Blob *blob = (Blob *)extract_byte_array_from_param(info, 0, "blob");
-  if (env.IsExceptionPending()) {
+  auto kzg_settings = get_kzg_settings(env, info[1]);
+  if (kzg_settings == NULL) {
     return env.Null();
   }
 
-  auto kzg_settings = info[1].As<Napi::External<KZGSettings>>().Data();
+  Blob *blob = (Blob *)extract_sized_byte_array_from_param(
+    info, 0, "blob", bytes_per_blob(kzg_settings), true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
 
   KZGCommitment commitment;
   C_KZG_RET ret = blob_to_kzg_commitment(&commitment, blob, kzg_settings);
@@ -162,31 +405,27 @@ Napi::Value ComputeAggregateKzgProof(const Napi::CallbackInfo& info) {
     return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
   }
 
-  auto blobs_param = info[0].As<Napi::Array>();
-  auto kzg_settings = info[1].As<Napi::External<KZGSettings>>().Data();
-
-  auto blobs_count = blobs_param.Length();
-
-  auto blobs = (Blob*)calloc(blobs_count, sizeof(Blob));
-  if (blobs == NULL) {
-    Napi::Error::New(env, "Error while allocating memory for blobs").ThrowAsJavaScriptException();
+  Napi::Array blobs_param;
+  if (!extract_array_from_param(info, 0, "blobs", blobs_param)) {
     return env.Null();
-  };
+  }
+  auto kzg_settings = get_kzg_settings(env, info[1]);
+  if (kzg_settings == NULL) {
+    return env.Null();
+  }
 
-  for (uint32_t blob_index = 0; blob_index < blobs_count; blob_index++) {
-    Napi::Value blob = blobs_param[blob_index];
-    auto blob_bytes = blob.As<Napi::Uint8Array>().Data();
-    memcpy(blobs[blob_index].bytes, blob_bytes, BYTES_PER_BLOB);
+  std::vector<uint8_t> blobs;
+  if (!copy_blobs(blobs, blobs_param, "blobs", kzg_settings, env)) {
+    return env.Null();
   }
 
   KZGProof proof;
   C_KZG_RET ret = compute_aggregate_kzg_proof(
     &proof,
-    blobs,
-    blobs_count,
+    (Blob *)blobs.data(),
+    blobs_param.Length(),
     kzg_settings
   );
-  free(blobs);
 
   if (ret != C_KZG_OK) {
      Napi::Error::New(env, "Failed to compute aggregated proof")
@@ -207,9 +446,15 @@ Napi::Value ComputeKzgProof(const Napi::CallbackInfo& info) {
     return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
   }
 
-  auto blob = extract_byte_array_from_param(info, 0, "blob");
+  auto kzg_settings = get_kzg_settings(env, info[2]);
+  if (kzg_settings == NULL) {
+    return env.Null();
+  }
+  auto blob = extract_sized_byte_array_from_param(info, 0, "blob", bytes_per_blob(kzg_settings), true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
   auto z_bytes = extract_byte_array_from_param(info, 1, "zBytes");
-  auto kzg_settings = info[2].As<Napi::External<KZGSettings>>().Data();
 
   KZGProof proof;
   C_KZG_RET ret = compute_kzg_proof(
@@ -238,54 +483,41 @@ Napi::Value VerifyAggregateKzgProof(const Napi::CallbackInfo& info) {
     return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
   }
 
-  auto blobs_param = info[0].As<Napi::Array>();
-  auto commitments_param = info[1].As<Napi::Array>();
-  auto proof_param = info[2].As<Napi::TypedArray>();
-  auto kzg_settings = info[3].As<Napi::External<KZGSettings>>().Data();
-
-  auto proof_bytes = proof_param.As<Napi::Uint8Array>().Data();
-  auto blobs_count = blobs_param.Length();
-
-  auto blobs = (Blob*)calloc(blobs_count, sizeof(Blob));
-  if (blobs == NULL) {
-    Napi::Error::New(env, "Error while allocating memory for blobs").ThrowAsJavaScriptException();
+  Napi::Array blobs_param, commitments_param;
+  if (!extract_array_from_param(info, 0, "blobs", blobs_param)
+      || !extract_array_from_param(info, 1, "commitmentsBytes", commitments_param)) {
     return env.Null();
-  };
-
-  auto commitments = (Bytes48*)calloc(blobs_count, sizeof(Bytes48));
-  if (commitments == NULL) {
-    free(blobs);
-    Napi::Error::New(env, "Error while allocating memory for commitments").ThrowAsJavaScriptException();
+  }
+  if (commitments_param.Length() != blobs_param.Length()) {
+    Napi::RangeError::New(env, "There must be one commitment per blob").ThrowAsJavaScriptException();
     return env.Null();
-  };
-
-  C_KZG_RET ret;
-
-  for (uint32_t blob_index = 0; blob_index < blobs_count; blob_index++) {
-    // Extract blob bytes from parameter
-    Napi::Value blob = blobs_param[blob_index];
-    auto blob_bytes = blob.As<Napi::Uint8Array>().Data();
-    memcpy(blobs[blob_index].bytes, blob_bytes, BYTES_PER_BLOB);
+  }
+  auto proof_bytes = extract_sized_byte_array_from_param(info, 2, "aggregatedProofBytes", BYTES_PER_PROOF, true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+  auto kzg_settings = get_kzg_settings(env, info[3]);
+  if (kzg_settings == NULL) {
+    return env.Null();
+  }
 
-    // Extract commitment from parameter
-    Napi::Value commitment = commitments_param[blob_index];
-    auto commitment_bytes = commitment.As<Napi::Uint8Array>().Data();
-    memcpy(&commitments[blob_index], commitment_bytes, BYTES_PER_COMMITMENT);
+  std::vector<uint8_t> blobs;
+  std::vector<Bytes48> commitments;
+  if (!copy_blobs(blobs, blobs_param, "blobs", kzg_settings, env)
+      || !copy_items(commitments, commitments_param, "commitmentsBytes", env)) {
+    return env.Null();
   }
 
   bool verification_result;
-  ret = verify_aggregate_kzg_proof(
+  C_KZG_RET ret = verify_aggregate_kzg_proof(
     &verification_result,
-    blobs,
-    commitments,
-    blobs_count,
+    (Blob *)blobs.data(),
+    commitments.data(),
+    blobs_param.Length(),
     (Bytes48 *)proof_bytes,
     kzg_settings
   );
 
-  free(commitments);
-  free(blobs);
-
   if (ret != C_KZG_OK) {
     Napi::Error::New(
       env,
@@ -311,7 +543,10 @@ Napi::Value VerifyKzgProof(const Napi::CallbackInfo& info) {
   auto z_bytes = extract_byte_array_from_param(info, 1, "zBytes");
   auto y_bytes = extract_byte_array_from_param(info, 2, "yBytes");
   auto proof_bytes = extract_byte_array_from_param(info, 3, "proofBytes");
-  auto kzg_settings = info[4].As<Napi::External<KZGSettings>>().Data();
+  auto kzg_settings = get_kzg_settings(env, info[4]);
+  if (kzg_settings == NULL) {
+    return env.Null();
+  }
 
   if (env.IsExceptionPending()) {
     return env.Null();
@@ -335,17 +570,564 @@ Napi::Value VerifyKzgProof(const Napi::CallbackInfo& info) {
   return Napi::Boolean::New(env, out);
 }
 
+/*
+ * Contiguous variants
+ *
+ * These take all blobs as one Uint8Array of n blobs of the setup's size, and
+ * write results into buffers from the caller. The data is handed straight to
+ * C, so nothing is copied or allocated per call.
+ */
+
+// blobToKzgCommitmentInto: (blob: Blob, out: KZGCommitment, setupHandle: SetupHandle) => void;
+Napi::Value BlobToKzgCommitmentInto(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  size_t argument_count = info.Length();
+  size_t expected_argument_count = 3;
+  if (argument_count != expected_argument_count) {
+    return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
+  }
+
+  auto kzg_settings = get_kzg_settings(env, info[2]);
+  if (kzg_settings == NULL) {
+    return env.Null();
+  }
+  auto blob = extract_sized_byte_array_from_param(info, 0, "blob", bytes_per_blob(kzg_settings), true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+  auto out = extract_sized_byte_array_from_param(info, 1, "out", BYTES_PER_COMMITMENT, true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+
+  C_KZG_RET ret = blob_to_kzg_commitment((KZGCommitment *)out, (Blob *)blob, kzg_settings);
+  if (ret != C_KZG_OK) {
+    Napi::Error::New(env, "Failed to convert blob to commitment").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  return env.Undefined();
+}
+
+// computeKzgProofInto: (blob: Blob, zBytes: Bytes32, out: KZGProof, setupHandle: SetupHandle) => void;
+Napi::Value ComputeKzgProofInto(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  size_t argument_count = info.Length();
+  size_t expected_argument_count = 4;
+  if (argument_count != expected_argument_count) {
+    return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
+  }
+
+  auto kzg_settings = get_kzg_settings(env, info[3]);
+  if (kzg_settings == NULL) {
+    return env.Null();
+  }
+  auto blob = extract_sized_byte_array_from_param(info, 0, "blob", bytes_per_blob(kzg_settings), true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+  auto z_bytes = extract_sized_byte_array_from_param(info, 1, "zBytes", BYTES_PER_FIELD_ELEMENT, true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+  auto out = extract_sized_byte_array_from_param(info, 2, "out", BYTES_PER_PROOF, true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+
+  C_KZG_RET ret = compute_kzg_proof((KZGProof *)out, (Blob *)blob, (Bytes32 *)z_bytes, kzg_settings);
+  if (ret != C_KZG_OK) {
+    Napi::Error::New(env, "Failed to compute proof").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  return env.Undefined();
+}
+
+// computeAggregateKzgProofInto: (blobs: Uint8Array, out: KZGProof, setupHandle: SetupHandle) => void;
+Napi::Value ComputeAggregateKzgProofInto(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  size_t argument_count = info.Length();
+  size_t expected_argument_count = 3;
+  if (argument_count != expected_argument_count) {
+    return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
+  }
+
+  auto kzg_settings = get_kzg_settings(env, info[2]);
+  if (kzg_settings == NULL) {
+    return env.Null();
+  }
+  size_t blobs_count;
+  auto blobs = extract_sized_byte_array_from_param(
+    info, 0, "blobs", bytes_per_blob(kzg_settings), false, &blobs_count);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+  auto out = extract_sized_byte_array_from_param(info, 1, "out", BYTES_PER_PROOF, true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+
+  C_KZG_RET ret = compute_aggregate_kzg_proof((KZGProof *)out, (Blob *)blobs, blobs_count, kzg_settings);
+  if (ret != C_KZG_OK) {
+    Napi::Error::New(env, "Failed to compute aggregated proof").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  return env.Undefined();
+}
+
+// verifyAggregateKzgProofContiguous: (blobs: Uint8Array, commitmentsBytes: Uint8Array, aggregatedProofBytes: Bytes48, setupHandle: SetupHandle) => boolean;
+Napi::Value VerifyAggregateKzgProofContiguous(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  size_t argument_count = info.Length();
+  size_t expected_argument_count = 4;
+  if (argument_count != expected_argument_count) {
+    return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
+  }
+
+  auto kzg_settings = get_kzg_settings(env, info[3]);
+  if (kzg_settings == NULL) {
+    return env.Null();
+  }
+  size_t blobs_count, commitments_count;
+  auto blobs = extract_sized_byte_array_from_param(
+    info, 0, "blobs", bytes_per_blob(kzg_settings), false, &blobs_count);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+  auto commitments = extract_sized_byte_array_from_param(
+    info, 1, "commitmentsBytes", BYTES_PER_COMMITMENT, false, &commitments_count
+  );
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+  if (commitments_count != blobs_count) {
+    Napi::RangeError::New(env, "There must be one commitment per blob").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  auto proof_bytes = extract_sized_byte_array_from_param(info, 2, "aggregatedProofBytes", BYTES_PER_PROOF, true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+
+  bool verification_result;
+  C_KZG_RET ret = verify_aggregate_kzg_proof(
+    &verification_result,
+    (Blob *)blobs,
+    (Bytes48 *)commitments,
+    blobs_count,
+    (Bytes48 *)proof_bytes,
+    kzg_settings
+  );
+  if (ret != C_KZG_OK) {
+    Napi::Error::New(
+      env,
+      "verify_aggregate_kzg_proof failed with error code: " + std::to_string(ret)
+    ).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  return Napi::Boolean::New(env, verification_result);
+}
+
+/*
+ * Async variants
+ *
+ * Each returns a Promise and runs the KZG function on the libuv thread pool.
+ * Blob arrays are copied on the main thread before the work is queued, since
+ * JS arrays cannot be read from other threads. Single buffers are passed by
+ * pointer, and a reference to each is held until the work is done so that
+ * its backing store stays alive; it must not be transferred meanwhile.
+ */
+
+class KzgWorker : public Napi::AsyncWorker {
+ public:
+  KzgWorker(Napi::Env env, SharedSetup *shared, const char *error_message)
+    : Napi::AsyncWorker(env),
+      kzg_settings(&shared->settings),
+      ret(C_KZG_OK),
+      deferred(Napi::Promise::Deferred::New(env)),
+      error_message(error_message),
+      shared(retain_shared_setup(shared)) {}
+
+  // Hold a reference to the setup until the worker is destroyed, so that it
+  // stays alive if its handle is freed or collected while the work runs
+  ~KzgWorker() override {
+    unref_shared_setup(shared);
+  }
+
+  Napi::Promise GetPromise() {
+    return deferred.Promise();
+  }
+
+  // Keep a JS value alive until the worker is done
+  void Retain(Napi::Value value) {
+    inputs.push_back(Napi::Persistent(value));
+  }
+
+ protected:
+  // Build the resolved value on the main thread, once ret is C_KZG_OK
+  virtual Napi::Value Result(Napi::Env env) = 0;
+
+  // The message to reject with when ret is not C_KZG_OK
+  virtual std::string ErrorMessage() {
+    return error_message;
+  }
+
+  void OnOK() override {
+    auto env = Env();
+    if (ret != C_KZG_OK) {
+      deferred.Reject(Napi::Error::New(env, ErrorMessage()).Value());
+      return;
+    }
+    deferred.Resolve(Result(env));
+  }
+
+  void OnError(const Napi::Error& e) override {
+    deferred.Reject(e.Value());
+  }
+
+  KZGSettings *kzg_settings;
+  C_KZG_RET ret;
+
+ private:
+  Napi::Promise::Deferred deferred;
+  std::vector<Napi::Reference<Napi::Value>> inputs;
+  std::string error_message;
+  SharedSetup *shared;
+};
+
+class BlobToKzgCommitmentWorker : public KzgWorker {
+ public:
+  BlobToKzgCommitmentWorker(Napi::Env env, const Blob *blob, SharedSetup *shared)
+    : KzgWorker(env, shared, "Failed to convert blob to commitment"), blob(blob) {}
+
+ protected:
+  void Execute() override {
+    ret = blob_to_kzg_commitment(&commitment, blob, kzg_settings);
+  }
+
+  Napi::Value Result(Napi::Env env) override {
+    return napi_typed_array_from_bytes((uint8_t *)(&commitment), BYTES_PER_COMMITMENT, env);
+  }
+
+ private:
+  const Blob *blob;
+  KZGCommitment commitment;
+};
+
+// blobToKzgCommitmentAsync: (blob: Blob, setupHandle: SetupHandle) => Promise<KZGCommitment>;
+Napi::Value BlobToKzgCommitmentAsync(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  size_t argument_count = info.Length();
+  size_t expected_argument_count = 2;
+  if (argument_count != expected_argument_count) {
+    return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
+  }
+
+  auto shared = get_shared_setup(env, info[1]);
+  if (shared == NULL) {
+    return env.Null();
+  }
+
+  Blob *blob = (Blob *)extract_sized_byte_array_from_param(
+    info, 0, "blob", bytes_per_blob(&shared->settings), true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+
+  auto worker = new BlobToKzgCommitmentWorker(env, blob, shared);
+  worker->Retain(info[0]);
+  auto promise = worker->GetPromise();
+  worker->Queue();
+  return promise;
+}
+
+class ComputeKzgProofWorker : public KzgWorker {
+ public:
+  ComputeKzgProofWorker(Napi::Env env, const Blob *blob, const Bytes32 *z_bytes, SharedSetup *shared)
+    : KzgWorker(env, shared, "Failed to compute proof"), blob(blob), z_bytes(z_bytes) {}
+
+ protected:
+  void Execute() override {
+    ret = compute_kzg_proof(&proof, blob, z_bytes, kzg_settings);
+  }
+
+  Napi::Value Result(Napi::Env env) override {
+    return napi_typed_array_from_bytes((uint8_t *)(&proof), BYTES_PER_PROOF, env);
+  }
+
+ private:
+  const Blob *blob;
+  const Bytes32 *z_bytes;
+  KZGProof proof;
+};
+
+// computeKzgProofAsync: (blob: Blob, zBytes: Bytes32, setupHandle: SetupHandle) => Promise<KZGProof>;
+Napi::Value ComputeKzgProofAsync(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  size_t argument_count = info.Length();
+  size_t expected_argument_count = 3;
+  if (argument_count != expected_argument_count) {
+    return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
+  }
+
+  auto shared = get_shared_setup(env, info[2]);
+  if (shared == NULL) {
+    return env.Null();
+  }
+
+  auto blob = extract_sized_byte_array_from_param(
+    info, 0, "blob", bytes_per_blob(&shared->settings), true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+  auto z_bytes = extract_sized_byte_array_from_param(info, 1, "zBytes", BYTES_PER_FIELD_ELEMENT, true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+
+  auto worker = new ComputeKzgProofWorker(env, (Blob *)blob, (Bytes32 *)z_bytes, shared);
+  worker->Retain(info[0]);
+  worker->Retain(info[1]);
+  auto promise = worker->GetPromise();
+  worker->Queue();
+  return promise;
+}
+
+class ComputeAggregateKzgProofWorker : public KzgWorker {
+ public:
+  ComputeAggregateKzgProofWorker(Napi::Env env, SharedSetup *shared)
+    : KzgWorker(env, shared, "Failed to compute aggregated proof") {}
+
+  std::vector<uint8_t> blobs;
+  size_t blobs_count = 0;
+
+ protected:
+  void Execute() override {
+    ret = compute_aggregate_kzg_proof(&proof, (Blob *)blobs.data(), blobs_count, kzg_settings);
+  }
+
+  Napi::Value Result(Napi::Env env) override {
+    return napi_typed_array_from_bytes((uint8_t *)(&proof), BYTES_PER_PROOF, env);
+  }
+
+ private:
+  KZGProof proof;
+};
+
+// computeAggregateKzgProofAsync: (blobs: Blob[], setupHandle: SetupHandle) => Promise<KZGProof>;
+Napi::Value ComputeAggregateKzgProofAsync(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  size_t argument_count = info.Length();
+  size_t expected_argument_count = 2;
+  if (argument_count != expected_argument_count) {
+    return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
+  }
+
+  Napi::Array blobs_param;
+  if (!extract_array_from_param(info, 0, "blobs", blobs_param)) {
+    return env.Null();
+  }
+  auto shared = get_shared_setup(env, info[1]);
+  if (shared == NULL) {
+    return env.Null();
+  }
+
+  auto worker = new ComputeAggregateKzgProofWorker(env, shared);
+  worker->blobs_count = blobs_param.Length();
+  if (!copy_blobs(worker->blobs, blobs_param, "blobs", &shared->settings, env)) {
+    delete worker;
+    return env.Null();
+  }
+  auto promise = worker->GetPromise();
+  worker->Queue();
+  return promise;
+}
+
+class VerifyAggregateKzgProofWorker : public KzgWorker {
+ public:
+  VerifyAggregateKzgProofWorker(Napi::Env env, const Bytes48 *proof_bytes, SharedSetup *shared)
+    : KzgWorker(env, shared, ""), proof_bytes(proof_bytes) {}
+
+  std::vector<uint8_t> blobs;
+  std::vector<Bytes48> commitments;
+
+ protected:
+  void Execute() override {
+    ret = verify_aggregate_kzg_proof(
+      &verification_result,
+      (Blob *)blobs.data(),
+      commitments.data(),
+      commitments.size(),
+      proof_bytes,
+      kzg_settings
+    );
+  }
+
+  Napi::Value Result(Napi::Env env) override {
+    return Napi::Boolean::New(env, verification_result);
+  }
+
+  std::string ErrorMessage() override {
+    return "verify_aggregate_kzg_proof failed with error code: " + std::to_string(ret);
+  }
+
+ private:
+  const Bytes48 *proof_bytes;
+  bool verification_result;
+};
+
+// verifyAggregateKzgProofAsync: (blobs: Blob[], commitmentsBytes: Bytes48[], aggregatedProofBytes: Bytes48, setupHandle: SetupHandle) => Promise<boolean>;
+Napi::Value VerifyAggregateKzgProofAsync(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  size_t argument_count = info.Length();
+  size_t expected_argument_count = 4;
+  if (argument_count != expected_argument_count) {
+    return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
+  }
+
+  Napi::Array blobs_param, commitments_param;
+  if (!extract_array_from_param(info, 0, "blobs", blobs_param)
+      || !extract_array_from_param(info, 1, "commitmentsBytes", commitments_param)) {
+    return env.Null();
+  }
+  if (commitments_param.Length() != blobs_param.Length()) {
+    Napi::RangeError::New(env, "There must be one commitment per blob").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  auto proof_bytes = extract_sized_byte_array_from_param(info, 2, "aggregatedProofBytes", BYTES_PER_PROOF, true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+  auto shared = get_shared_setup(env, info[3]);
+  if (shared == NULL) {
+    return env.Null();
+  }
+
+  auto worker = new VerifyAggregateKzgProofWorker(env, (Bytes48 *)proof_bytes, shared);
+  worker->Retain(info[2]);
+  if (!copy_blobs(worker->blobs, blobs_param, "blobs", &shared->settings, env)
+      || !copy_items(worker->commitments, commitments_param, "commitmentsBytes", env)) {
+    delete worker;
+    return env.Null();
+  }
+
+  auto promise = worker->GetPromise();
+  worker->Queue();
+  return promise;
+}
+
+class VerifyKzgProofWorker : public KzgWorker {
+ public:
+  VerifyKzgProofWorker(
+    Napi::Env env,
+    const Bytes48 *commitment_bytes,
+    const Bytes32 *z_bytes,
+    const Bytes32 *y_bytes,
+    const Bytes48 *proof_bytes,
+    SharedSetup *shared
+  ) : KzgWorker(env, shared, "Failed to verify KZG proof"),
+      commitment_bytes(commitment_bytes),
+      z_bytes(z_bytes),
+      y_bytes(y_bytes),
+      proof_bytes(proof_bytes) {}
+
+ protected:
+  void Execute() override {
+    ret = verify_kzg_proof(&out, commitment_bytes, z_bytes, y_bytes, proof_bytes, kzg_settings);
+  }
+
+  Napi::Value Result(Napi::Env env) override {
+    return Napi::Boolean::New(env, out);
+  }
+
+ private:
+  const Bytes48 *commitment_bytes;
+  const Bytes32 *z_bytes;
+  const Bytes32 *y_bytes;
+  const Bytes48 *proof_bytes;
+  bool out;
+};
+
+// verifyKzgProofAsync: (commitmentBytes: Bytes48, zBytes: Bytes32, yBytes: Bytes32, proofBytes: Bytes48, setupHandle: SetupHandle) => Promise<boolean>;
+Napi::Value VerifyKzgProofAsync(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  size_t argument_count = info.Length();
+  size_t expected_argument_count = 5;
+  if (argument_count != expected_argument_count) {
+    return throw_invalid_arguments_count(expected_argument_count, argument_count, env);
+  }
+
+  auto commitment_bytes = extract_sized_byte_array_from_param(info, 0, "commitmentBytes", BYTES_PER_COMMITMENT, true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+  auto z_bytes = extract_sized_byte_array_from_param(info, 1, "zBytes", BYTES_PER_FIELD_ELEMENT, true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+  auto y_bytes = extract_sized_byte_array_from_param(info, 2, "yBytes", BYTES_PER_FIELD_ELEMENT, true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+  auto proof_bytes = extract_sized_byte_array_from_param(info, 3, "proofBytes", BYTES_PER_PROOF, true, NULL);
+  if (env.IsExceptionPending()) {
+    return env.Null();
+  }
+  auto shared = get_shared_setup(env, info[4]);
+  if (shared == NULL) {
+    return env.Null();
+  }
+
+  auto worker = new VerifyKzgProofWorker(
+    env,
+    (Bytes48 *)commitment_bytes,
+    (Bytes32 *)z_bytes,
+    (Bytes32 *)y_bytes,
+    (Bytes48 *)proof_bytes,
+    shared
+  );
+  for (int i = 0; i < 4; i++) {
+    worker->Retain(info[i]);
+  }
+  auto promise = worker->GetPromise();
+  worker->Queue();
+  return promise;
+}
+
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
   // Functions
   exports["loadTrustedSetup"] = Napi::Function::New(env, LoadTrustedSetup);
   exports["freeTrustedSetup"] = Napi::Function::New(env, FreeTrustedSetup);
+  exports["trustedSetupRefCount"] = Napi::Function::New(env, TrustedSetupRefCount);
+  exports["fieldElementsPerBlob"] = Napi::Function::New(env, FieldElementsPerBlob);
   exports["blobToKzgCommitment"] = Napi::Function::New(env, BlobToKzgCommitment);
   exports["computeKzgProof"] = Napi::Function::New(env, ComputeKzgProof);
   exports["verifyKzgProof"] = Napi::Function::New(env, VerifyKzgProof);
   exports["computeAggregateKzgProof"] = Napi::Function::New(env, ComputeAggregateKzgProof);
   exports["verifyAggregateKzgProof"] = Napi::Function::New(env, VerifyAggregateKzgProof);
-
-  // Constants
+  exports["blobToKzgCommitmentInto"] = Napi::Function::New(env, BlobToKzgCommitmentInto);
+  exports["computeKzgProofInto"] = Napi::Function::New(env, ComputeKzgProofInto);
+  exports["computeAggregateKzgProofInto"] = Napi::Function::New(env, ComputeAggregateKzgProofInto);
+  exports["verifyAggregateKzgProofContiguous"] = Napi::Function::New(env, VerifyAggregateKzgProofContiguous);
+  exports["blobToKzgCommitmentAsync"] = Napi::Function::New(env, BlobToKzgCommitmentAsync);
+  exports["computeKzgProofAsync"] = Napi::Function::New(env, ComputeKzgProofAsync);
+  exports["verifyKzgProofAsync"] = Napi::Function::New(env, VerifyKzgProofAsync);
+  exports["computeAggregateKzgProofAsync"] = Napi::Function::New(env, ComputeAggregateKzgProofAsync);
+  exports["verifyAggregateKzgProofAsync"] = Napi::Function::New(env, VerifyAggregateKzgProofAsync);
+
+  // Constants, FIELD_ELEMENTS_PER_BLOB being the largest supported
   exports["FIELD_ELEMENTS_PER_BLOB"] = Napi::Number::New(env, FIELD_ELEMENTS_PER_BLOB);
   exports["BYTES_PER_FIELD_ELEMENT"] = Napi::Number::New(env, BYTES_PER_FIELD_ELEMENT);
 
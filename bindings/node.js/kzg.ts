@@ -9,19 +9,26 @@ export type Bytes32 = Uint8Array; // 32 bytes
 export type Bytes48 = Uint8Array; // 48 bytes
 export type KZGProof = Uint8Array; // 48 bytes
 export type KZGCommitment = Uint8Array; // 48 bytes
-export type Blob = Uint8Array; // 4096 * 32 bytes
+export type Blob = Uint8Array; // fieldElementsPerBlob() * 32 bytes
 
 type SetupHandle = Object;
 
 // The C++ native addon interface
 type KZG = {
+  // The largest blob size supported, each setup selecting its own
   FIELD_ELEMENTS_PER_BLOB: number;
   BYTES_PER_FIELD_ELEMENT: number;
 
+  // Setups are shared by every isolate in the process that loads the same
+  // path, and freed once the last handle is freed or collected
   loadTrustedSetup: (filePath: string) => SetupHandle;
 
   freeTrustedSetup: (setupHandle: SetupHandle) => void;
 
+  trustedSetupRefCount: (setupHandle: SetupHandle) => number;
+
+  fieldElementsPerBlob: (setupHandle: SetupHandle) => number;
+
   blobToKzgCommitment: (blob: Blob, setupHandle: SetupHandle) => KZGCommitment;
 
   computeKzgProof: (
@@ -49,6 +56,66 @@ type KZG = {
     proofBytes: Bytes48,
     setupHandle: SetupHandle,
   ) => boolean;
+
+  // The contiguous variants take all blobs in one buffer, and write results
+  // into buffers from the caller
+  blobToKzgCommitmentInto: (
+    blob: Blob,
+    out: KZGCommitment,
+    setupHandle: SetupHandle,
+  ) => void;
+
+  computeKzgProofInto: (
+    blob: Blob,
+    zBytes: Bytes32,
+    out: KZGProof,
+    setupHandle: SetupHandle,
+  ) => void;
+
+  computeAggregateKzgProofInto: (
+    blobs: Uint8Array,
+    out: KZGProof,
+    setupHandle: SetupHandle,
+  ) => void;
+
+  verifyAggregateKzgProofContiguous: (
+    blobs: Uint8Array,
+    commitmentsBytes: Uint8Array,
+    aggregatedProofBytes: Bytes48,
+    setupHandle: SetupHandle,
+  ) => boolean;
+
+  // The async variants run on the libuv thread pool
+  blobToKzgCommitmentAsync: (
+    blob: Blob,
+    setupHandle: SetupHandle,
+  ) => Promise<KZGCommitment>;
+
+  computeKzgProofAsync: (
+    blob: Blob,
+    zBytes: Bytes32,
+    setupHandle: SetupHandle,
+  ) => Promise<KZGProof>;
+
+  computeAggregateKzgProofAsync: (
+    blobs: Blob[],
+    setupHandle: SetupHandle,
+  ) => Promise<KZGProof>;
+
+  verifyAggregateKzgProofAsync: (
+    blobs: Blob[],
+    commitmentsBytes: Bytes48[],
+    aggregatedProofBytes: Bytes48,
+    setupHandle: SetupHandle,
+  ) => Promise<boolean>;
+
+  verifyKzgProofAsync: (
+    commitmentBytes: Bytes48,
+    zBytes: Bytes32,
+    yBytes: Bytes32,
+    proofBytes: Bytes48,
+    setupHandle: SetupHandle,
+  ) => Promise<boolean>;
 };
 
 type TrustedSetupJSON = {
@@ -83,7 +150,7 @@ export async function transformTrustedSetupJSON(
   } catch {}
 
   const file = fs.createWriteStream(textFilePath);
-  file.write(`${FIELD_ELEMENTS_PER_BLOB}\n65\n`);
+  file.write(`${data.setup_G1.length}\n65\n`);
   file.write(data.setup_G1.map((p) => p.replace("0x", "")).join("\n"));
   file.write("\n");
   file.write(data.setup_G2.map((p) => p.replace("0x", "")).join("\n"));
@@ -112,6 +179,14 @@ export function freeTrustedSetup(): void {
   setupHandle = undefined;
 }
 
+/**
+ * The number of field elements per blob of the loaded setup, which blobs
+ * passed to every other function must match.
+ */
+export function fieldElementsPerBlob(): number {
+  return kzg.fieldElementsPerBlob(requireSetupHandle());
+}
+
 export function blobToKzgCommitment(blob: Blob): KZGCommitment {
   return kzg.blobToKzgCommitment(blob, requireSetupHandle());
 }
@@ -120,7 +195,16 @@ export function computeKzgProof(blob: Blob, zBytes: Bytes32): KZGProof {
   return kzg.computeKzgProof(blob, zBytes, requireSetupHandle());
 }
 
-export function computeAggregateKzgProof(blobs: Blob[]): KZGProof {
+/**
+ * Blobs may be given as an array, or as one buffer of n blobs, which is passed
+ * to C without being copied.
+ */
+export function computeAggregateKzgProof(blobs: Blob[] | Uint8Array): KZGProof {
+  if (!Array.isArray(blobs)) {
+    const out = new Uint8Array(48);
+    kzg.computeAggregateKzgProofInto(blobs, out, requireSetupHandle());
+    return out;
+  }
   return kzg.computeAggregateKzgProof(blobs, requireSetupHandle());
 }
 
@@ -139,11 +223,29 @@ export function verifyKzgProof(
   );
 }
 
+/**
+ * Blobs and commitments may each be given as an array, or together as one
+ * buffer of n blobs and one of n * 48 bytes, which are passed to C without
+ * being copied.
+ */
 export function verifyAggregateKzgProof(
-  blobs: Blob[],
-  commitmentsBytes: Bytes48[],
+  blobs: Blob[] | Uint8Array,
+  commitmentsBytes: Bytes48[] | Uint8Array,
   proofBytes: Bytes48,
 ): boolean {
+  if (!Array.isArray(blobs) && !Array.isArray(commitmentsBytes)) {
+    return kzg.verifyAggregateKzgProofContiguous(
+      blobs,
+      commitmentsBytes,
+      proofBytes,
+      requireSetupHandle(),
+    );
+  }
+  if (!Array.isArray(blobs) || !Array.isArray(commitmentsBytes)) {
+    throw new TypeError(
+      "Blobs and commitments must both be arrays, or both be buffers.",
+    );
+  }
   return kzg.verifyAggregateKzgProof(
     blobs,
     commitmentsBytes,
@@ -151,3 +253,93 @@ export function verifyAggregateKzgProof(
     requireSetupHandle(),
   );
 }
+
+/*
+ * Variants that write their result into a buffer from the caller, for hot
+ * paths that reuse their output buffers.
+ */
+
+export function blobToKzgCommitmentInto(
+  blob: Blob,
+  out: KZGCommitment,
+): KZGCommitment {
+  kzg.blobToKzgCommitmentInto(blob, out, requireSetupHandle());
+  return out;
+}
+
+export function computeKzgProofInto(
+  blob: Blob,
+  zBytes: Bytes32,
+  out: KZGProof,
+): KZGProof {
+  kzg.computeKzgProofInto(blob, zBytes, out, requireSetupHandle());
+  return out;
+}
+
+export function computeAggregateKzgProofInto(
+  blobs: Uint8Array,
+  out: KZGProof,
+): KZGProof {
+  kzg.computeAggregateKzgProofInto(blobs, out, requireSetupHandle());
+  return out;
+}
+
+/*
+ * Async variants, which run on the libuv thread pool instead of blocking the
+ * event loop. Input buffers are held until the returned Promise settles and
+ * must not be transferred or modified meanwhile. Each call holds its own
+ * reference to the trusted setup, so it may be freed while calls are pending.
+ */
+
+async function withSetupHandle<T>(
+  call: (setupHandle: SetupHandle) => Promise<T>,
+): Promise<T> {
+  return call(requireSetupHandle());
+}
+
+export function blobToKzgCommitmentAsync(blob: Blob): Promise<KZGCommitment> {
+  return withSetupHandle((handle) => kzg.blobToKzgCommitmentAsync(blob, handle));
+}
+
+export function computeKzgProofAsync(
+  blob: Blob,
+  zBytes: Bytes32,
+): Promise<KZGProof> {
+  return withSetupHandle((handle) =>
+    kzg.computeKzgProofAsync(blob, zBytes, handle),
+  );
+}
+
+export function computeAggregateKzgProofAsync(
+  blobs: Blob[],
+): Promise<KZGProof> {
+  return withSetupHandle((handle) =>
+    kzg.computeAggregateKzgProofAsync(blobs, handle),
+  );
+}
+
+export function verifyKzgProofAsync(
+  commitmentBytes: Bytes48,
+  zBytes: Bytes32,
+  yBytes: Bytes32,
+  proofBytes: Bytes48,
+): Promise<boolean> {
+  return withSetupHandle((handle) =>
+    kzg.verifyKzgProofAsync(commitmentBytes, zBytes, yBytes, proofBytes, handle),
+  );
+}
+
+export function verifyAggregateKzgProofAsync(
+  blobs: Blob[],
+  commitmentsBytes: Bytes48[],
+  proofBytes: Bytes48,
+): Promise<boolean> {
+  return withSetupHandle((handle) =>
+    kzg.verifyAggregateKzgProofAsync(
+      blobs,
+      commitmentsBytes,
+      proofBytes,
+      handle,
+    ),
+  );
+}
@@ -1,5 +1,5 @@
 import { randomBytes } from "crypto";
-import { existsSync } from "fs";
+import { copyFileSync, existsSync, unlinkSync } from "fs";
 
 import {
   loadTrustedSetup,
@@ -12,6 +12,15 @@ import {
   BYTES_PER_FIELD_ELEMENT,
   FIELD_ELEMENTS_PER_BLOB,
   transformTrustedSetupJSON,
+  blobToKzgCommitmentAsync,
+  computeKzgProofAsync,
+  blobToKzgCommitmentInto,
+  computeKzgProofInto,
+  computeAggregateKzgProofInto,
+  computeAggregateKzgProofAsync,
+  verifyKzgProofAsync,
+  verifyAggregateKzgProofAsync,
+  fieldElementsPerBlob,
 } from "./kzg";
 
 const setupFileName = "testing_trusted_setups.json";
@@ -24,9 +33,9 @@ const BLOB_BYTE_COUNT = FIELD_ELEMENTS_PER_BLOB * BYTES_PER_FIELD_ELEMENT;
 
 const MAX_TOP_BYTE = 114;
 
-const generateRandomBlob = () => {
+const generateRandomBlob = (byteCount = BLOB_BYTE_COUNT) => {
   return new Uint8Array(
-    randomBytes(BLOB_BYTE_COUNT).map((x, i) => {
+    randomBytes(byteCount).map((x, i) => {
       // Set the top byte to be low enough that the field element doesn't overflow the BLS modulus
       if (x > MAX_TOP_BYTE && i % BYTES_PER_FIELD_ELEMENT == 31) {
         return Math.floor(Math.random() * MAX_TOP_BYTE);
@@ -116,6 +125,206 @@ describe("C-KZG", () => {
     ).toThrowError("verify_aggregate_kzg_proof failed with error code: 1");
   });
 
+  describe("shared setups", () => {
+    const native = require("./kzg.node");
+
+    it("share one copy per path until the last handle is freed", async () => {
+      const file = await transformTrustedSetupJSON(SETUP_FILE_PATH);
+      const first = native.loadTrustedSetup(file);
+      const second = native.loadTrustedSetup(file);
+      expect(native.trustedSetupRefCount(first)).toBeGreaterThanOrEqual(2);
+      expect(native.trustedSetupRefCount(second)).toEqual(
+        native.trustedSetupRefCount(first),
+      );
+
+      const blob = generateRandomBlob();
+      native.freeTrustedSetup(first);
+      expect(native.trustedSetupRefCount(first)).toBe(0);
+      expect(native.blobToKzgCommitment(blob, second)).toEqual(
+        blobToKzgCommitment(blob),
+      );
+      native.freeTrustedSetup(second);
+    });
+
+    it("reject values that are not handles", () => {
+      for (const fn of [native.freeTrustedSetup, native.trustedSetupRefCount]) {
+        expect(() => fn({})).toThrowError(
+          "Invalid argument type: setupHandle. Expected SetupHandle",
+        );
+      }
+    });
+
+    it("stay alive for pending async calls after the handle is freed", async () => {
+      // A separate path, so that the global setup does not hold a reference
+      const file = await transformTrustedSetupJSON(SETUP_FILE_PATH);
+      const copy = `${file}.copy`;
+      copyFileSync(file, copy);
+      try {
+        const handle = native.loadTrustedSetup(copy);
+        const blob = generateRandomBlob();
+        const pending = native.blobToKzgCommitmentAsync(blob, handle);
+        native.freeTrustedSetup(handle);
+        expect(native.trustedSetupRefCount(handle)).toBe(0);
+        expect(await pending).toEqual(blobToKzgCommitment(blob));
+        expect(() => native.blobToKzgCommitment(blob, handle)).toThrowError(
+          "The trusted setup has been freed",
+        );
+      } finally {
+        unlinkSync(copy);
+      }
+    });
+  });
+
+  describe("setups of other presets", () => {
+    const native = require("./kzg.node");
+
+    it("check blob sizes against the setup in use", async () => {
+      expect(fieldElementsPerBlob()).toBe(FIELD_ELEMENTS_PER_BLOB);
+
+      const handle = native.loadTrustedSetup("../../src/trusted_setup_4.txt");
+      try {
+        expect(native.fieldElementsPerBlob(handle)).toBe(4);
+        const blobs = new Array(2)
+          .fill(0)
+          .map(() => generateRandomBlob(4 * BYTES_PER_FIELD_ELEMENT));
+        const commitments = blobs.map((blob) =>
+          native.blobToKzgCommitment(blob, handle),
+        );
+        const proof = native.computeAggregateKzgProof(blobs, handle);
+        expect(
+          native.verifyAggregateKzgProof(blobs, commitments, proof, handle),
+        ).toBe(true);
+        expect(
+          await native.computeAggregateKzgProofAsync(blobs, handle),
+        ).toEqual(proof);
+
+        expect(() =>
+          native.blobToKzgCommitment(generateRandomBlob(), handle),
+        ).toThrowError("Invalid length of blob");
+      } finally {
+        native.freeTrustedSetup(handle);
+      }
+    });
+  });
+
+  describe("contiguous variants", () => {
+    const concat = (arrays: Uint8Array[]) => {
+      const out = new Uint8Array(arrays.reduce((n, a) => n + a.length, 0));
+      arrays.reduce((offset, a) => {
+        out.set(a, offset);
+        return offset + a.length;
+      }, 0);
+      return out;
+    };
+
+    it("match the array results", () => {
+      const blobs = new Array(3).fill(0).map(generateRandomBlob);
+      const commitments = blobs.map(blobToKzgCommitment);
+      const packedBlobs = concat(blobs);
+      const packedCommitments = concat(commitments);
+
+      const proof = computeAggregateKzgProof(packedBlobs);
+      expect(proof).toEqual(computeAggregateKzgProof(blobs));
+      expect(
+        verifyAggregateKzgProof(packedBlobs, packedCommitments, proof),
+      ).toBe(true);
+
+      const out = new Uint8Array(48);
+      expect(computeAggregateKzgProofInto(packedBlobs, out)).toBe(out);
+      expect(out).toEqual(proof);
+      expect(blobToKzgCommitmentInto(blobs[1], out)).toEqual(commitments[1]);
+
+      const zBytes = new Uint8Array(32).fill(0);
+      expect(computeKzgProofInto(blobs[0], zBytes, out)).toEqual(
+        computeKzgProof(blobs[0], zBytes),
+      );
+    });
+
+    it("throws when the buffer is not a whole number of blobs", () => {
+      expect(() =>
+        computeAggregateKzgProof(new Uint8Array(BLOB_BYTE_COUNT + 1)),
+      ).toThrowError("Invalid length of blobs");
+    });
+
+    it("throws when there is not one commitment per blob", () => {
+      const blobs = concat(new Array(2).fill(0).map(generateRandomBlob));
+      const proof = computeAggregateKzgProof(blobs);
+      expect(() =>
+        verifyAggregateKzgProof(blobs, new Uint8Array(48), proof),
+      ).toThrowError("There must be one commitment per blob");
+    });
+  });
+
+  describe("async variants", () => {
+    it("match the synchronous results", async () => {
+      const blobs = new Array(2).fill(0).map(generateRandomBlob);
+      const commitments = await Promise.all(
+        blobs.map(blobToKzgCommitmentAsync),
+      );
+      expect(commitments).toEqual(blobs.map(blobToKzgCommitment));
+
+      const proof = await computeAggregateKzgProofAsync(blobs);
+      expect(proof).toEqual(computeAggregateKzgProof(blobs));
+      await expect(
+        verifyAggregateKzgProofAsync(blobs, commitments, proof),
+      ).resolves.toBe(true);
+
+      const zBytes = new Uint8Array(32).fill(0);
+      expect(await computeKzgProofAsync(blobs[0], zBytes)).toEqual(
+        computeKzgProof(blobs[0], zBytes),
+      );
+    });
+
+    it("verifies a valid KZG proof", async () => {
+      const commitment = new Uint8Array(48).fill(0);
+      commitment[0] = 0xc0;
+      const z = new Uint8Array(32).fill(0);
+      const y = new Uint8Array(32).fill(0);
+      const proof = new Uint8Array(48).fill(0);
+      proof[0] = 0xc0;
+
+      await expect(verifyKzgProofAsync(commitment, z, y, proof)).resolves.toBe(
+        true,
+      );
+    });
+
+    it("rejects when given incorrect commitments", async () => {
+      const blobs = new Array(2).fill(0).map(generateRandomBlob);
+      const commitments = blobs.map(blobToKzgCommitment);
+      commitments[0][0] = commitments[0][0] === 0 ? 1 : 0; // Mutate the commitment
+      const proof = computeAggregateKzgProof(blobs);
+      await expect(
+        verifyAggregateKzgProofAsync(blobs, commitments, proof),
+      ).rejects.toThrowError(
+        "verify_aggregate_kzg_proof failed with error code: 1",
+      );
+    });
+
+    it("rejects when there is not one commitment per blob", async () => {
+      const blobs = new Array(2).fill(0).map(generateRandomBlob);
+      const commitments = blobs.map(blobToKzgCommitment).slice(1);
+      const proof = computeAggregateKzgProof(blobs);
+      await expect(
+        verifyAggregateKzgProofAsync(blobs, commitments, proof),
+      ).rejects.toThrowError("There must be one commitment per blob");
+    });
+
+    it("rejects when an item has the wrong length", async () => {
+      const blobs = new Array(2).fill(0).map(generateRandomBlob);
+      const commitments = blobs.map(blobToKzgCommitment);
+      const proof = computeAggregateKzgProof(blobs);
+      commitments[1] = commitments[1].subarray(1);
+      await expect(
+        verifyAggregateKzgProofAsync(blobs, commitments, proof),
+      ).rejects.toThrowError("Invalid length of commitmentsBytes[1]");
+
+      blobs[1] = blobs[1].subarray(1);
+      await expect(computeAggregateKzgProofAsync(blobs)).rejects.toThrowError(
+        "Invalid length of blobs[1]",
+      );
+    });
+  });
+
   describe("computing commitment from blobs", () => {
     it("throws as expected when given an argument of invalid type", () => {
       // @ts-expect-error
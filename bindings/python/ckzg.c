@@ -8,17 +8,70 @@ static void free_KZGSettings(PyObject *c) {
   free(s);
 }
 
+/*
+ * Get a C-contiguous view of any object that supports the buffer protocol,
+ * e.g. bytes, bytearray, memoryview, mmap or a numpy array, without copying.
+ * The view must be released with PyBuffer_Release.
+ *
+ * The length in bytes must be a multiple of unit, and with exact set, equal
+ * to it. Returns 0 on success, or -1 with an exception set.
+ */
+static int get_buffer(Py_buffer *view, PyObject *obj, int writable,
+    Py_ssize_t unit, int exact, const char *name) {
+  int flags = PyBUF_C_CONTIGUOUS | (writable ? PyBUF_WRITABLE : 0);
+
+  if (PyObject_GetBuffer(obj, view, flags) != 0) {
+    PyErr_Clear();
+    PyErr_Format(PyExc_ValueError, "expected %s to be a contiguous%s buffer",
+        name, writable ? " writable" : "");
+    return -1;
+  }
+
+  if (exact ? view->len != unit : view->len % unit != 0) {
+    PyErr_Format(PyExc_ValueError, "expected %s to be %s%zd bytes",
+        name, exact ? "" : "a multiple of ", unit);
+    PyBuffer_Release(view);
+    return -1;
+  }
+
+  return 0;
+}
+
+/*
+ * The module is built for the largest blob size, and each setup selects its
+ * own, so blob sizes are checked against the setup.
+ */
+static Py_ssize_t bytes_per_blob(const KZGSettings *s) {
+  return (Py_ssize_t)kzg_settings_field_elements_per_blob(s) * BYTES_PER_FIELD_ELEMENT;
+}
+
 static PyObject* load_trusted_setup_wrap(PyObject *self, PyObject *args) {
   PyObject *f;
 
   if (!PyArg_ParseTuple(args, "U", &f))
     return PyErr_Format(PyExc_ValueError, "expected a string");
 
+  const char *path = PyUnicode_AsUTF8(f);
+  if (path == NULL) return NULL;
+
+  FILE *in = fopen(path, "r");
+  if (in == NULL)
+    return PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, f);
+
   KZGSettings *s = (KZGSettings*)malloc(sizeof(KZGSettings));
 
-  if (s == NULL) return PyErr_NoMemory();
+  if (s == NULL) {
+    fclose(in);
+    return PyErr_NoMemory();
+  }
+
+  C_KZG_RET ret;
+  Py_BEGIN_ALLOW_THREADS
+  ret = load_trusted_setup_file(s, in);
+  fclose(in);
+  Py_END_ALLOW_THREADS
 
-  if (load_trusted_setup_file(s, fopen(PyUnicode_AsUTF8(f), "r")) != C_KZG_OK) {
+  if (ret != C_KZG_OK) {
     free(s);
     return PyErr_Format(PyExc_RuntimeError, "error loading trusted setup");
   }
@@ -26,24 +79,43 @@ static PyObject* load_trusted_setup_wrap(PyObject *self, PyObject *args) {
   return PyCapsule_New(s, "KZGSettings", free_KZGSettings);
 }
 
+static PyObject* field_elements_per_blob_wrap(PyObject *self, PyObject *args) {
+  PyObject *s;
+
+  if (!PyArg_UnpackTuple(args, "field_elements_per_blob", 1, 1, &s) ||
+      !PyCapsule_IsValid(s, "KZGSettings"))
+    return PyErr_Format(PyExc_ValueError, "expected trusted setup");
+
+  const KZGSettings *settings = PyCapsule_GetPointer(s, "KZGSettings");
+  return PyLong_FromUnsignedLongLong(kzg_settings_field_elements_per_blob(settings));
+}
+
 static PyObject* blob_to_kzg_commitment_wrap(PyObject *self, PyObject *args) {
   PyObject *b;
   PyObject *s;
+  Py_buffer blob;
 
   if (!PyArg_UnpackTuple(args, "blob_to_kzg_commitment_wrap", 2, 2, &b, &s) ||
-      !PyBytes_Check(b) ||
       !PyCapsule_IsValid(s, "KZGSettings"))
-    return PyErr_Format(PyExc_ValueError, "expected bytes and trusted setup");
+    return PyErr_Format(PyExc_ValueError, "expected buffer and trusted setup");
 
-  if (PyBytes_Size(b) != BYTES_PER_BLOB)
-    return PyErr_Format(PyExc_ValueError, "expected blobs to be BYTES_PER_BLOB bytes");
+  const KZGSettings *settings = PyCapsule_GetPointer(s, "KZGSettings");
+  if (get_buffer(&blob, b, 0, bytes_per_blob(settings), 1, "blob") != 0) return NULL;
 
   PyObject *out = PyBytes_FromStringAndSize(NULL, BYTES_PER_COMMITMENT);
-  if (out == NULL) return PyErr_NoMemory();
+  if (out == NULL) {
+    PyBuffer_Release(&blob);
+    return PyErr_NoMemory();
+  }
 
-  Blob *blob = (Blob *)PyBytes_AsString(b);
   KZGCommitment *k = (KZGCommitment *)PyBytes_AsString(out);
-  if (blob_to_kzg_commitment(k, blob, PyCapsule_GetPointer(s, "KZGSettings")) != C_KZG_OK) {
+  C_KZG_RET ret;
+  Py_BEGIN_ALLOW_THREADS
+  ret = blob_to_kzg_commitment(k, blob.buf, settings);
+  Py_END_ALLOW_THREADS
+  PyBuffer_Release(&blob);
+
+  if (ret != C_KZG_OK) {
     Py_DECREF(out);
     return PyErr_Format(PyExc_RuntimeError, "blob_to_kzg_commitment failed");
   }
@@ -51,26 +123,223 @@ static PyObject* blob_to_kzg_commitment_wrap(PyObject *self, PyObject *args) {
   return out;
 }
 
+/* The number of blobs or groups handed to the native threads at a time */
+#define BATCH_CHUNK 1024
+
+/*
+ * The threads of batches with the default num_threads, one per CPU, started
+ * by the first such batch and kept until the module is freed. Batches share
+ * it, one falling back to its calling thread while another is in progress.
+ */
+static KZGExecutor *default_pool = NULL;
+
+/*
+ * A batch of blobs or groups of blobs being processed by native threads.
+ * Entry i is count[i] blobs at blobs[i], and its result goes to out[i].
+ */
+typedef struct {
+  const KZGSettings *s;
+  const Blob *blobs[BATCH_CHUNK];
+  size_t count[BATCH_CHUNK];
+  Bytes48 *out;
+  C_KZG_RET ret[BATCH_CHUNK];
+  Py_buffer views[BATCH_CHUNK];
+  size_t num_views;
+} Batch;
+
+static void commitment_task(void *arg, size_t i) {
+  Batch *b = arg;
+  b->ret[i] = blob_to_kzg_commitment(&b->out[i], b->blobs[i], b->s);
+}
+
+static void proof_task(void *arg, size_t i) {
+  Batch *b = arg;
+  b->ret[i] = compute_aggregate_kzg_proof(&b->out[i], b->blobs[i], b->count[i], b->s);
+}
+
+/*
+ * Run a task for every entry of blobs, writing the results to out.
+ *
+ * blobs is either a single contiguous buffer, of which each blob is an entry,
+ * or any iterable of buffers, each of which is an entry: one blob when
+ * group is 0, or a group of blobs when it is 1. Iterables are consumed a
+ * chunk at a time, holding only the views of the current chunk.
+ *
+ * The entries are spread over num_threads native threads, or over the
+ * module's threads when it is 0, with the GIL released. A chunk of a single
+ * entry runs on the calling thread. Returns the number of results written,
+ * or -1 with an exception set.
+ */
+static Py_ssize_t run_batch(PyObject *blobs, PyObject *o, PyObject *s,
+    Py_ssize_t num_threads, kzg_task_fn task, int group, const char *name) {
+  Py_buffer whole, out;
+  PyObject *iter = NULL;
+  Batch *b = NULL;
+  KZGExecutor *pool = NULL, *own_pool = NULL;
+  Py_ssize_t done = -1, total = 0, next = 0, capacity, blob_size, k, i;
+  int exhausted = 0;
+  C_KZG_RET ret = C_KZG_OK;
+
+  if (!PyCapsule_IsValid(s, "KZGSettings")) {
+    PyErr_Format(PyExc_ValueError, "expected trusted setup");
+    return -1;
+  }
+  if (num_threads < 0) {
+    PyErr_Format(PyExc_ValueError, "expected num_threads to be non-negative");
+    return -1;
+  }
+
+  blob_size = bytes_per_blob(PyCapsule_GetPointer(s, "KZGSettings"));
+
+  whole.obj = NULL;
+  if (!group && PyObject_CheckBuffer(blobs)) {
+    if (get_buffer(&whole, blobs, 0, blob_size, 0, "blobs") != 0) return -1;
+    total = whole.len / blob_size;
+  } else if ((iter = PyObject_GetIter(blobs)) == NULL) {
+    PyErr_Format(PyExc_ValueError, "expected blobs to be a buffer or an iterable of buffers");
+    return -1;
+  }
+
+  if (get_buffer(&out, o, 1, BYTES_PER_COMMITMENT, 0, "out") != 0) goto out_whole;
+  capacity = out.len / BYTES_PER_COMMITMENT;
+  if (iter == NULL && total > capacity) {
+    PyErr_Format(PyExc_ValueError, "expected out to hold %zd results", total);
+    goto out_out;
+  }
+
+  b = PyMem_Malloc(sizeof(Batch));
+  if (b == NULL) {
+    PyErr_NoMemory();
+    goto out_out;
+  }
+  b->s = PyCapsule_GetPointer(s, "KZGSettings");
+  b->num_views = 0;
+
+  /* The GIL is held while the module's threads start, so they start once */
+  if (num_threads == 0 && default_pool == NULL)
+    ret = new_kzg_thread_pool(&default_pool, 0);
+  else if (num_threads > 1) {
+    Py_BEGIN_ALLOW_THREADS
+    ret = new_kzg_thread_pool(&own_pool, num_threads);
+    Py_END_ALLOW_THREADS
+  }
+  if (ret != C_KZG_OK) {
+    PyErr_Format(PyExc_RuntimeError, "could not start threads");
+    goto out_batch;
+  }
+  pool = num_threads == 0 ? default_pool : own_pool;
+
+  done = 0;
+  while (!exhausted) {
+    for (k = 0; k < BATCH_CHUNK; k++) {
+      if (iter == NULL) {
+        if (next == total) break;
+        b->blobs[k] = (const Blob *)((const uint8_t *)whole.buf + next++ * blob_size);
+        b->count[k] = 1;
+        continue;
+      }
+      PyObject *item = PyIter_Next(iter);
+      if (item == NULL) break;
+      int err = get_buffer(&b->views[k], item, 0, blob_size, !group, name);
+      Py_DECREF(item);
+      if (err != 0) break;
+      b->num_views++;
+      b->blobs[k] = b->views[k].buf;
+      b->count[k] = b->views[k].len / blob_size;
+    }
+    exhausted = k < BATCH_CHUNK;
+    if (PyErr_Occurred()) goto out_views;
+
+    if (done + k > capacity) {
+      PyErr_Format(PyExc_ValueError, "expected out to hold more than %zd results", capacity);
+      goto out_views;
+    }
+    b->out = (Bytes48 *)out.buf + done;
+
+    Py_BEGIN_ALLOW_THREADS
+    if (pool != NULL && k > 1)
+      pool->parallel_for(pool->ctx, task, b, k);
+    else
+      for (i = 0; i < k; i++) task(b, i);
+    Py_END_ALLOW_THREADS
+
+    for (i = 0; i < k; i++) {
+      if (b->ret[i] != C_KZG_OK) {
+        PyErr_Format(PyExc_RuntimeError, "%s %zd failed", name, done + i);
+        goto out_views;
+      }
+    }
+    for (i = 0; i < (Py_ssize_t)b->num_views; i++) PyBuffer_Release(&b->views[i]);
+    b->num_views = 0;
+    done += k;
+  }
+
+out_views:
+  for (i = 0; i < (Py_ssize_t)b->num_views; i++) PyBuffer_Release(&b->views[i]);
+  if (PyErr_Occurred()) done = -1;
+  free_kzg_thread_pool(own_pool);
+out_batch:
+  PyMem_Free(b);
+out_out:
+  PyBuffer_Release(&out);
+out_whole:
+  if (whole.obj != NULL) PyBuffer_Release(&whole);
+  Py_XDECREF(iter);
+  return done;
+}
+
+static PyObject* blob_to_kzg_commitments_into_wrap(PyObject *self, PyObject *args, PyObject *kwargs) {
+  static char *kwlist[] = {"blobs", "out", "setup", "num_threads", NULL};
+  PyObject *b, *o, *s;
+  Py_ssize_t num_threads = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOO|n:blob_to_kzg_commitments_into", kwlist,
+        &b, &o, &s, &num_threads))
+    return NULL;
+
+  Py_ssize_t n = run_batch(b, o, s, num_threads, commitment_task, 0, "blob");
+  return n < 0 ? NULL : PyLong_FromSsize_t(n);
+}
+
+static PyObject* compute_aggregate_kzg_proofs_into_wrap(PyObject *self, PyObject *args, PyObject *kwargs) {
+  static char *kwlist[] = {"groups", "out", "setup", "num_threads", NULL};
+  PyObject *g, *o, *s;
+  Py_ssize_t num_threads = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OOO|n:compute_aggregate_kzg_proofs_into", kwlist,
+        &g, &o, &s, &num_threads))
+    return NULL;
+
+  Py_ssize_t n = run_batch(g, o, s, num_threads, proof_task, 1, "group");
+  return n < 0 ? NULL : PyLong_FromSsize_t(n);
+}
+
 static PyObject* compute_aggregate_kzg_proof_wrap(PyObject *self, PyObject *args) {
   PyObject *b, *s;
+  Py_buffer blobs;
 
   if (!PyArg_UnpackTuple(args, "compute_aggregate_kzg_proof", 2, 2, &b, &s) ||
-      !PyBytes_Check(b) ||
       !PyCapsule_IsValid(s, "KZGSettings"))
-    return PyErr_Format(PyExc_ValueError, "expected bytes, trusted setup");
+    return PyErr_Format(PyExc_ValueError, "expected buffer, trusted setup");
 
-  Py_ssize_t n = PyBytes_Size(b);
-  if (n % BYTES_PER_BLOB != 0)
-    return PyErr_Format(PyExc_ValueError, "expected blobs to be a multiple of BYTES_PER_BLOB bytes");
-  n = n / BYTES_PER_BLOB;
+  const KZGSettings *settings = PyCapsule_GetPointer(s, "KZGSettings");
+  if (get_buffer(&blobs, b, 0, bytes_per_blob(settings), 0, "blobs") != 0) return NULL;
+  size_t n = blobs.len / bytes_per_blob(settings);
 
   PyObject *out = PyBytes_FromStringAndSize(NULL, BYTES_PER_PROOF);
-  if (out == NULL) return PyErr_NoMemory();
+  if (out == NULL) {
+    PyBuffer_Release(&blobs);
+    return PyErr_NoMemory();
+  }
 
-  Blob *blobs = (Blob *)PyBytes_AsString(b);
   KZGProof *k = (KZGProof *)PyBytes_AsString(out);
-  if (compute_aggregate_kzg_proof(k, blobs, n,
-        PyCapsule_GetPointer(s, "KZGSettings")) != C_KZG_OK) {
+  C_KZG_RET ret;
+  Py_BEGIN_ALLOW_THREADS
+  ret = compute_aggregate_kzg_proof(k, blobs.buf, n, settings);
+  Py_END_ALLOW_THREADS
+  PyBuffer_Release(&blobs);
+
+  if (ret != C_KZG_OK) {
     Py_DECREF(out);
     return PyErr_Format(PyExc_RuntimeError, "compute_aggregate_kzg_proof failed");
   }
@@ -78,61 +347,113 @@ static PyObject* compute_aggregate_kzg_proof_wrap(PyObject *self, PyObject *args
   return out;
 }
 
+static PyObject* compute_aggregate_kzg_proof_into_wrap(PyObject *self, PyObject *args) {
+  PyObject *b, *o, *s;
+  Py_buffer blobs, out;
+
+  if (!PyArg_UnpackTuple(args, "compute_aggregate_kzg_proof_into", 3, 3, &b, &o, &s) ||
+      !PyCapsule_IsValid(s, "KZGSettings"))
+    return PyErr_Format(PyExc_ValueError, "expected buffer, writable buffer, trusted setup");
+
+  const KZGSettings *settings = PyCapsule_GetPointer(s, "KZGSettings");
+  if (get_buffer(&blobs, b, 0, bytes_per_blob(settings), 0, "blobs") != 0) return NULL;
+  size_t n = blobs.len / bytes_per_blob(settings);
+
+  if (get_buffer(&out, o, 1, BYTES_PER_PROOF, 1, "out") != 0) {
+    PyBuffer_Release(&blobs);
+    return NULL;
+  }
+
+  C_KZG_RET ret;
+  Py_BEGIN_ALLOW_THREADS
+  ret = compute_aggregate_kzg_proof(out.buf, blobs.buf, n, settings);
+  Py_END_ALLOW_THREADS
+  PyBuffer_Release(&out);
+  PyBuffer_Release(&blobs);
+
+  if (ret != C_KZG_OK)
+    return PyErr_Format(PyExc_RuntimeError, "compute_aggregate_kzg_proof failed");
+
+  Py_RETURN_NONE;
+}
+
 static PyObject* verify_aggregate_kzg_proof_wrap(PyObject *self, PyObject *args) {
   PyObject *b, *c, *p, *s;
+  Py_buffer blobs, commitments, proof;
 
   if (!PyArg_UnpackTuple(args, "verify_aggregate_kzg_proof", 4, 4, &b, &c, &p, &s) ||
-      !PyBytes_Check(b) ||
-      !PyBytes_Check(c) ||
-      !PyBytes_Check(p) ||
       !PyCapsule_IsValid(s, "KZGSettings"))
     return PyErr_Format(PyExc_ValueError,
-        "expected bytes, bytes, bytes, trusted setup");
+        "expected buffer, buffer, buffer, trusted setup");
 
-  if (PyBytes_Size(p) != BYTES_PER_PROOF)
-    return PyErr_Format(PyExc_ValueError, "expected proof to be BYTES_PER_PROOF bytes");
+  const KZGSettings *settings = PyCapsule_GetPointer(s, "KZGSettings");
+  if (get_buffer(&proof, p, 0, BYTES_PER_PROOF, 1, "proof") != 0) return NULL;
 
-  Py_ssize_t n = PyBytes_Size(b);
-  if (n % BYTES_PER_BLOB != 0)
-    return PyErr_Format(PyExc_ValueError, "expected blobs to be a multiple of BYTES_PER_BLOB bytes");
-  n = n / BYTES_PER_BLOB;
+  if (get_buffer(&blobs, b, 0, bytes_per_blob(settings), 0, "blobs") != 0) {
+    PyBuffer_Release(&proof);
+    return NULL;
+  }
+  size_t n = blobs.len / bytes_per_blob(settings);
 
-  Py_ssize_t m = PyBytes_Size(c);
-   if (m % BYTES_PER_COMMITMENT != 0)
-     return PyErr_Format(PyExc_ValueError, "expected commitments to be a multiple of BYTES_PER_COMMITMENT bytes");
-   m = m / BYTES_PER_COMMITMENT;
+  if (get_buffer(&commitments, c, 0, BYTES_PER_COMMITMENT, 0, "commitments") != 0) {
+    PyBuffer_Release(&blobs);
+    PyBuffer_Release(&proof);
+    return NULL;
+  }
+  size_t m = commitments.len / BYTES_PER_COMMITMENT;
 
-  if (m != n)
+  if (m != n) {
+    PyBuffer_Release(&commitments);
+    PyBuffer_Release(&blobs);
+    PyBuffer_Release(&proof);
     return PyErr_Format(PyExc_ValueError, "expected same number of commitments as polynomials");
-
-  const Blob* blobs = (Blob *)PyBytes_AsString(b);
-  const Bytes48 *proof_bytes = (Bytes48 *)PyBytes_AsString(p);
-  const Bytes48 *commitments_bytes = (Bytes48 *)PyBytes_AsString(c);
+  }
 
   bool out;
-  if (verify_aggregate_kzg_proof(&out,
-        blobs, commitments_bytes, n, proof_bytes,
-        PyCapsule_GetPointer(s, "KZGSettings")) != C_KZG_OK) {
+  C_KZG_RET ret;
+  Py_BEGIN_ALLOW_THREADS
+  ret = verify_aggregate_kzg_proof(&out,
+        blobs.buf, commitments.buf, n, proof.buf, settings);
+  Py_END_ALLOW_THREADS
+  PyBuffer_Release(&commitments);
+  PyBuffer_Release(&blobs);
+  PyBuffer_Release(&proof);
+
+  if (ret != C_KZG_OK)
     return PyErr_Format(PyExc_RuntimeError, "verify_aggregate_kzg_proof failed");
-  }
 
   if (out) Py_RETURN_TRUE; else Py_RETURN_FALSE;
 }
 
 static PyMethodDef ckzgmethods[] = {
-  {"load_trusted_setup",          load_trusted_setup_wrap,          METH_VARARGS, "Load trusted setup from file path"},
-  {"blob_to_kzg_commitment",      blob_to_kzg_commitment_wrap,      METH_VARARGS, "Create a commitment from a blob"},
-  {"compute_aggregate_kzg_proof", compute_aggregate_kzg_proof_wrap, METH_VARARGS, "Compute aggregate KZG proof"},
-  {"verify_aggregate_kzg_proof",  verify_aggregate_kzg_proof_wrap,  METH_VARARGS, "Verify aggregate KZG proof"},
+  {"load_trusted_setup",               load_trusted_setup_wrap,               METH_VARARGS, "Load trusted setup from file path"},
+  {"field_elements_per_blob",          field_elements_per_blob_wrap,          METH_VARARGS, "Get the field elements per blob of a trusted setup"},
+  {"blob_to_kzg_commitment",           blob_to_kzg_commitment_wrap,           METH_VARARGS, "Create a commitment from a blob"},
+  {"blob_to_kzg_commitments_into",     (PyCFunction)(void(*)(void))blob_to_kzg_commitments_into_wrap, METH_VARARGS | METH_KEYWORDS,
+                                       "Write the commitments of a buffer or iterable of blobs into a buffer on native threads, returning their number"},
+  {"compute_aggregate_kzg_proof",      compute_aggregate_kzg_proof_wrap,      METH_VARARGS, "Compute aggregate KZG proof"},
+  {"compute_aggregate_kzg_proof_into", compute_aggregate_kzg_proof_into_wrap, METH_VARARGS, "Write aggregate KZG proof into a buffer"},
+  {"compute_aggregate_kzg_proofs_into", (PyCFunction)(void(*)(void))compute_aggregate_kzg_proofs_into_wrap, METH_VARARGS | METH_KEYWORDS,
+                                       "Write the aggregate KZG proof of each group of blobs of an iterable into a buffer on native threads, returning their number"},
+  {"verify_aggregate_kzg_proof",       verify_aggregate_kzg_proof_wrap,       METH_VARARGS, "Verify aggregate KZG proof"},
   {NULL, NULL, 0, NULL}
 };
 
+static void free_ckzg(void *module) {
+  free_kzg_thread_pool(default_pool);
+  default_pool = NULL;
+}
+
 static struct PyModuleDef ckzg = {
   PyModuleDef_HEAD_INIT,
   "ckzg",
   NULL,
   -1,
-  ckzgmethods
+  ckzgmethods,
+  NULL,
+  NULL,
+  NULL,
+  free_ckzg
 };
 
 PyMODINIT_FUNC PyInit_ckzg(void) {
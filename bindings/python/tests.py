@@ -33,4 +33,65 @@ other_bytes = other + blobs_bytes[1:]
 
 assert not ckzg.verify_aggregate_kzg_proof(other_bytes, kzg_commitments, proof, ts), 'verify succeeded incorrectly'
 
+# Any contiguous buffer is accepted in place of bytes
+
+assert ckzg.blob_to_kzg_commitment(bytearray(blobs[0]), ts) == kzg_commitments[:48]
+assert ckzg.blob_to_kzg_commitment(memoryview(blobs_bytes)[:len(blobs[0])], ts) == kzg_commitments[:48]
+assert ckzg.compute_aggregate_kzg_proof(bytearray(blobs_bytes), ts) == proof
+assert ckzg.verify_aggregate_kzg_proof(memoryview(blobs_bytes), bytearray(kzg_commitments), memoryview(proof), ts)
+
+# Results can be written into preallocated buffers
+
+out = bytearray(len(kzg_commitments))
+assert ckzg.blob_to_kzg_commitments_into(memoryview(blobs_bytes), out, ts) == len(blobs)
+assert out == kzg_commitments
+
+out = bytearray(48)
+ckzg.compute_aggregate_kzg_proof_into(blobs_bytes, memoryview(out), ts)
+assert out == proof
+
+for args in [(blobs_bytes, bytes(len(kzg_commitments)), ts), (blobs_bytes, bytearray(48), ts)]:
+  try:
+    ckzg.blob_to_kzg_commitments_into(*args)
+    assert False, 'wrote into a read-only or wrongly sized buffer'
+  except ValueError:
+    pass
+
+# Batches can come from an iterable of blobs and run on several threads
+
+out = bytearray(len(kzg_commitments))
+assert ckzg.blob_to_kzg_commitments_into(iter(blobs), out, ts, num_threads=2) == len(blobs)
+assert out == kzg_commitments
+
+# Each group of an iterable gets its own aggregate proof
+
+view = memoryview(blobs_bytes)
+out = bytearray(2 * 48)
+assert ckzg.compute_aggregate_kzg_proofs_into([view, view[:len(blobs[0])]], out, ts) == 2
+assert out[:48] == proof
+assert out[48:] == ckzg.compute_aggregate_kzg_proof(blobs[0], ts)
+
+# One module supports the setups of every preset, and checks blob sizes against the one in use
+
+assert ckzg.field_elements_per_blob(ts) == BLOB_SIZE
+
+minimal_ts = ckzg.load_trusted_setup("../../src/trusted_setup_4.txt")
+assert ckzg.field_elements_per_blob(minimal_ts) == 4
+
+minimal_blobs = [blob[:4 * 32] for blob in blobs]
+minimal_blobs_bytes = b''.join(minimal_blobs)
+minimal_commitments = b''.join([ckzg.blob_to_kzg_commitment(blob, minimal_ts) for blob in minimal_blobs])
+minimal_proof = ckzg.compute_aggregate_kzg_proof(minimal_blobs_bytes, minimal_ts)
+assert ckzg.verify_aggregate_kzg_proof(minimal_blobs_bytes, minimal_commitments, minimal_proof, minimal_ts)
+
+out = bytearray(len(minimal_commitments))
+assert ckzg.blob_to_kzg_commitments_into(minimal_blobs_bytes, out, minimal_ts) == len(minimal_blobs)
+assert out == minimal_commitments
+
+try:
+  ckzg.blob_to_kzg_commitment(blobs[0], minimal_ts)
+  assert False, 'accepted a blob of another preset'
+except ValueError:
+  pass
+
 print('tests passed')
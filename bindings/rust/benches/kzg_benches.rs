@@ -24,7 +24,7 @@ pub fn criterion_benchmark(c: &mut Criterion) {
 
     let blob = generate_random_blob_for_bench(&mut rng);
     c.bench_function("blob_to_kzg_commitment", |b| {
-        b.iter(|| KZGCommitment::blob_to_kzg_commitment(blob, &kzg_settings))
+        b.iter(|| KZGCommitment::blob_to_kzg_commitment(blob, &kzg_settings).unwrap())
     });
 
     for num_blobs in [4, 8, 16].iter() {
@@ -43,7 +43,7 @@ pub fn criterion_benchmark(c: &mut Criterion) {
         let kzg_commitments: Vec<KZGCommitment> = blobs
             .clone()
             .into_iter()
-            .map(|blob| KZGCommitment::blob_to_kzg_commitment(blob, &kzg_settings))
+            .map(|blob| KZGCommitment::blob_to_kzg_commitment(blob, &kzg_settings).unwrap())
             .collect();
         let proof = KZGProof::compute_aggregate_kzg_proof(&blobs, &kzg_settings).unwrap();
 
@@ -2,8 +2,9 @@ use std::env;
 use std::path::{Path, PathBuf};
 use std::process::Command;
 
-const MAINNET_FIELD_ELEMENTS_PER_BLOB: usize = 4096;
-const MINIMAL_FIELD_ELEMENTS_PER_BLOB: usize = 4;
+/// The largest blob size supported. One build handles every preset up to it, and the
+/// trusted setup that is loaded selects the preset.
+const FIELD_ELEMENTS_PER_BLOB: usize = 4096;
 
 fn move_file(src: &Path, dst: &Path) -> Result<(), String> {
     std::fs::copy(src, dst)
@@ -30,16 +31,8 @@ fn main() {
     )
     .unwrap();
 
-    let field_elements_per_blob = if cfg!(feature = "minimal-spec") {
-        MINIMAL_FIELD_ELEMENTS_PER_BLOB
-    } else {
-        MAINNET_FIELD_ELEMENTS_PER_BLOB
-    };
-
-    eprintln!("Using FIELD_ELEMENTS_PER_BLOB={}", field_elements_per_blob);
-
-    // Deleting any existing assembly and object files to ensure that compiling with a different
-    // feature flag changes the final linked library file.
+    // Deleting any existing assembly and object files to ensure that the library is compiled
+    // with the flags below.
     let obj_file = root_dir.join("src/c_kzg_4844.o");
     if obj_file.exists() {
         std::fs::remove_file(obj_file).unwrap();
@@ -51,7 +44,7 @@ fn main() {
         .arg("all")
         .arg(format!(
             "FIELD_ELEMENTS_PER_BLOB={}",
-            field_elements_per_blob
+            FIELD_ELEMENTS_PER_BLOB
         ))
         .status()
         .unwrap();
@@ -78,7 +71,7 @@ fn main() {
         const_file,
         format!(
             "pub const FIELD_ELEMENTS_PER_BLOB: usize = {};",
-            field_elements_per_blob
+            FIELD_ELEMENTS_PER_BLOB
         ),
     )
     .unwrap();
@@ -172,12 +172,52 @@ pub enum C_KZG_RET {
 pub struct FFTSettings {
     #[doc = "< The maximum size of FFT these settings support, a power of 2."]
     max_width: u64,
-    #[doc = "< Ascending powers of the root of unity, size `width + 1`."]
-    expanded_roots_of_unity: *const fr_t,
-    #[doc = "< Descending powers of the root of unity, size `width + 1`."]
-    reverse_roots_of_unity: *const fr_t,
     #[doc = "< Powers of the root of unity in bit-reversal permutation, size `width`."]
     roots_of_unity: *const fr_t,
+    #[doc = "< The bit-reversal permuted powers, each divided by `width`, size `width`."]
+    roots_of_unity_div_width: *const fr_t,
+}
+
+#[doc = " Where the library gets its memory from."]
+#[repr(C)]
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct KZGAllocator {
+    #[doc = "< Allocate."]
+    pub malloc_fn: Option<
+        unsafe extern "C" fn(ctx: *mut libc::c_void, size: usize, alignment: usize) -> *mut libc::c_void,
+    >,
+    #[doc = "< Allocate zeroed space."]
+    pub calloc_fn: Option<
+        unsafe extern "C" fn(
+            ctx: *mut libc::c_void,
+            count: usize,
+            size: usize,
+            alignment: usize,
+        ) -> *mut libc::c_void,
+    >,
+    #[doc = "< Release."]
+    pub free_fn: Option<unsafe extern "C" fn(ctx: *mut libc::c_void, p: *mut libc::c_void)>,
+    #[doc = "< Passed to each function."]
+    pub ctx: *mut libc::c_void,
+}
+
+#[doc = " Runs the parallel loops of the library on the host's threads."]
+#[repr(C)]
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct KZGExecutor {
+    #[doc = "< Run a parallel loop."]
+    pub parallel_for: Option<
+        unsafe extern "C" fn(
+            ctx: *mut libc::c_void,
+            task: Option<unsafe extern "C" fn(arg: *mut libc::c_void, i: usize)>,
+            arg: *mut libc::c_void,
+            n: usize,
+        ),
+    >,
+    #[doc = "< Passed to `parallel_for`."]
+    pub ctx: *mut libc::c_void,
+    #[doc = "< How many tasks can usefully run at once."]
+    pub num_threads: usize,
 }
 
 #[doc = " Stores the setup and parameters needed for computing KZG proofs."]
@@ -186,10 +226,20 @@ pub struct FFTSettings {
 pub struct KZGSettings {
     #[doc = "< The corresponding settings for performing FFTs."]
     fs: *const FFTSettings,
-    #[doc = "< G1 group elements from the trusted setup, in Lagrange form bit-reversal permutation."]
-    g1_values: *const g1_t,
-    #[doc = "< G2 group elements from the trusted setup; both arrays have FIELD_ELEMENTS_PER_BLOB elements."]
+    #[doc = "< Affine G1 group elements from the trusted setup, in Lagrange form bit-reversal permutation."]
+    g1_values: *const blst_p1_affine,
+    #[doc = "< The first two G2 group elements from the trusted setup, `[1]` and `[s]`."]
     g2_values: *const g2_t,
+    #[doc = "< The settings image the tables point into, or NULL if they are on the heap."]
+    image: *const libc::c_void,
+    #[doc = "< The size of the mapping at `image`."]
+    image_size: usize,
+    #[doc = "< Copies of these settings indexed by NUMA node, or NULL."]
+    replicas: *mut KZGSettings,
+    #[doc = "< The number of `replicas`."]
+    num_replicas: usize,
+    #[doc = "< Runs the parallel loops, or NULL to run them on the calling thread."]
+    executor: *const KZGExecutor,
 }
 
 /// Safety: FFTSettings is initialized once on calling `load_trusted_setup`. After
@@ -212,6 +262,24 @@ extern "C" {
 
     pub fn free_trusted_setup(s: *mut KZGSettings);
 
+    pub fn publish_trusted_setup(path: *const libc::c_char, s: *const KZGSettings) -> C_KZG_RET;
+
+    pub fn attach_trusted_setup(out: *mut KZGSettings, path: *const libc::c_char) -> C_KZG_RET;
+
+    pub fn place_trusted_setup(s: *mut KZGSettings, flags: libc::c_uint) -> C_KZG_RET;
+
+    pub fn kzg_settings_field_elements_per_blob(s: *const KZGSettings) -> u64;
+
+    pub fn set_kzg_allocator(allocator: *const KZGAllocator);
+
+    pub fn release_kzg_thread_scratch();
+
+    pub fn set_trusted_setup_executor(s: *mut KZGSettings, executor: *const KZGExecutor);
+
+    pub fn new_kzg_thread_pool(out: *mut *mut KZGExecutor, num_threads: usize) -> C_KZG_RET;
+
+    pub fn free_kzg_thread_pool(pool: *mut KZGExecutor);
+
     pub fn compute_kzg_proof(
         out: *mut KZGProof,
         blob: *const Blob,
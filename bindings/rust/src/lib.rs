@@ -5,6 +5,7 @@
 include!("bindings.rs");
 
 use libc::fopen;
+use std::borrow::Cow;
 use std::ffi::CString;
 use std::mem::MaybeUninit;
 use std::os::unix::prelude::OsStrExt;
@@ -35,15 +36,16 @@ pub enum Error {
 
 /// Holds the parameters of a kzg trusted setup ceremony.
 impl KZGSettings {
-    /// Initializes a trusted setup from `FIELD_ELEMENTS_PER_BLOB` g1 points
-    /// and 65 g2 points in byte format.
+    /// Initializes a trusted setup from one g1 point per field element of a blob
+    /// and 65 g2 points in byte format. The number of g1 points selects the preset,
+    /// up to `FIELD_ELEMENTS_PER_BLOB`.
     pub fn load_trusted_setup(
         g1_bytes: Vec<[u8; BYTES_PER_G1_POINT]>,
         g2_bytes: Vec<[u8; BYTES_PER_G2_POINT]>,
     ) -> Result<Self, Error> {
-        if g1_bytes.len() != FIELD_ELEMENTS_PER_BLOB {
+        if g1_bytes.is_empty() || g1_bytes.len() > FIELD_ELEMENTS_PER_BLOB {
             return Err(Error::InvalidTrustedSetup(format!(
-                "Invalid number of g1 points in trusted setup. Expected {} got {}",
+                "Invalid number of g1 points in trusted setup. Expected at most {} got {}",
                 FIELD_ELEMENTS_PER_BLOB,
                 g1_bytes.len()
             )));
@@ -77,7 +79,7 @@ impl KZGSettings {
 
     /// Loads the trusted setup parameters from a file. The file format is as follows:
     ///
-    /// FIELD_ELEMENTS_PER_BLOB
+    /// FIELD_ELEMENTS_PER_BLOB # Of the preset, up to the compile time value.
     /// 65 # This is fixed and is used for providing multiproofs up to 64 field elements.
     /// FIELD_ELEMENT_PER_BLOB g1 byte values
     /// 65 g2 byte values
@@ -99,6 +101,52 @@ impl KZGSettings {
             }
         }
     }
+
+    /// The number of field elements in the blobs of this setup's preset.
+    pub fn field_elements_per_blob(&self) -> usize {
+        unsafe { kzg_settings_field_elements_per_blob(self) as usize }
+    }
+
+    /// The number of bytes of a blob that this setup reads. The rest of a `Blob`
+    /// must be zero.
+    pub fn bytes_per_blob(&self) -> usize {
+        self.field_elements_per_blob() * BYTES_PER_FIELD_ELEMENT
+    }
+
+    /// Checks that the blobs fit this setup, and returns them in the layout the
+    /// library reads arrays of blobs in: packed at the width of the setup.
+    fn pack_blobs<'a>(&self, blobs: &'a [Blob]) -> Result<Cow<'a, [u8]>, Error> {
+        for blob in blobs {
+            self.check_blob(blob)?;
+        }
+        let bytes_per_blob = self.bytes_per_blob();
+        if bytes_per_blob == BYTES_PER_BLOB {
+            let bytes = unsafe {
+                std::slice::from_raw_parts(
+                    blobs.as_ptr() as *const u8,
+                    blobs.len() * BYTES_PER_BLOB,
+                )
+            };
+            return Ok(Cow::Borrowed(bytes));
+        }
+        Ok(Cow::Owned(
+            blobs
+                .iter()
+                .flat_map(|blob| blob[..bytes_per_blob].iter().copied())
+                .collect(),
+        ))
+    }
+
+    fn check_blob(&self, blob: &Blob) -> Result<(), Error> {
+        let bytes_per_blob = self.bytes_per_blob();
+        if blob[bytes_per_blob..].iter().any(|&byte| byte != 0) {
+            return Err(Error::InvalidBytesLength(format!(
+                "Blob is larger than the trusted setup. Expected {} bytes",
+                bytes_per_blob
+            )));
+        }
+        Ok(())
+    }
 }
 
 impl Drop for KZGSettings {
@@ -107,6 +155,24 @@ impl Drop for KZGSettings {
     }
 }
 
+impl Blob {
+    /// Builds a blob of any preset up to `FIELD_ELEMENTS_PER_BLOB`. The bytes
+    /// past the end of the given ones are zero.
+    pub fn from_bytes(bytes: &[u8]) -> Result<Self, Error> {
+        if bytes.len() > BYTES_PER_BLOB || bytes.len() % BYTES_PER_FIELD_ELEMENT != 0 {
+            return Err(Error::InvalidBytesLength(format!(
+                "Invalid byte length. Expected a multiple of {} up to {} got {}",
+                BYTES_PER_FIELD_ELEMENT,
+                BYTES_PER_BLOB,
+                bytes.len(),
+            )));
+        }
+        let mut new_bytes = [0; BYTES_PER_BLOB];
+        new_bytes[..bytes.len()].copy_from_slice(bytes);
+        Ok(Self { bytes: new_bytes })
+    }
+}
+
 impl Bytes32 {
     pub fn from_bytes(bytes: &[u8]) -> Result<Self, Error> {
         if bytes.len() != 32 {
@@ -166,6 +232,10 @@ impl KZGProof {
         z_bytes: Bytes32,
         kzg_settings: &KZGSettings,
     ) -> Result<Self, Error> {
+        // A single blob needs no packing, it is only read up to the width of the setup
+        for blob in blob {
+            kzg_settings.check_blob(blob)?;
+        }
         let mut kzg_proof = MaybeUninit::<KZGProof>::uninit();
         unsafe {
             let res = compute_kzg_proof(
@@ -186,11 +256,12 @@ impl KZGProof {
         blobs: &[Blob],
         kzg_settings: &KZGSettings,
     ) -> Result<Self, Error> {
+        let packed_blobs = kzg_settings.pack_blobs(blobs)?;
         let mut kzg_proof = MaybeUninit::<KZGProof>::uninit();
         unsafe {
             let res = compute_aggregate_kzg_proof(
                 kzg_proof.as_mut_ptr(),
-                blobs.as_ptr(),
+                packed_blobs.as_ptr() as *const Blob,
                 blobs.len(),
                 kzg_settings,
             );
@@ -215,11 +286,12 @@ impl KZGProof {
                 commitments_bytes.len()
             )));
         }
+        let packed_blobs = kzg_settings.pack_blobs(blobs)?;
         let mut verified: MaybeUninit<bool> = MaybeUninit::uninit();
         unsafe {
             let res = verify_aggregate_kzg_proof(
                 verified.as_mut_ptr(),
-                blobs.as_ptr(),
+                packed_blobs.as_ptr() as *const Blob,
                 commitments_bytes.as_ptr(),
                 blobs.len(),
                 &self.to_bytes(),
@@ -283,15 +355,20 @@ impl KZGCommitment {
         hex::encode(self.bytes)
     }
 
-    pub fn blob_to_kzg_commitment(blob: Blob, kzg_settings: &KZGSettings) -> Self {
+    pub fn blob_to_kzg_commitment(blob: Blob, kzg_settings: &KZGSettings) -> Result<Self, Error> {
+        kzg_settings.check_blob(&blob)?;
         let mut kzg_commitment: MaybeUninit<KZGCommitment> = MaybeUninit::uninit();
         unsafe {
-            blob_to_kzg_commitment(
+            let res = blob_to_kzg_commitment(
                 kzg_commitment.as_mut_ptr(),
                 blob.as_ptr() as *const Blob,
                 kzg_settings,
             );
-            kzg_commitment.assume_init()
+            if let C_KZG_RET::C_KZG_OK = res {
+                Ok(kzg_commitment.assume_init())
+            } else {
+                Err(Error::CError(res))
+            }
         }
     }
 }
@@ -331,12 +408,12 @@ mod tests {
     use super::*;
     use rand::{rngs::ThreadRng, Rng};
 
-    fn generate_random_blob(rng: &mut ThreadRng) -> Blob {
+    fn generate_random_blob(rng: &mut ThreadRng, kzg_settings: &KZGSettings) -> Blob {
         let mut arr = [0u8; BYTES_PER_BLOB];
-        rng.fill(&mut arr[..]);
+        rng.fill(&mut arr[..kzg_settings.bytes_per_blob()]);
         // Ensure that the blob is canonical by ensuring that
         // each field element contained in the blob is < BLS_MODULUS
-        for i in 0..FIELD_ELEMENTS_PER_BLOB {
+        for i in 0..kzg_settings.field_elements_per_blob() {
             arr[i * BYTES_PER_FIELD_ELEMENT + BYTES_PER_FIELD_ELEMENT - 1] = 0;
         }
         arr.into()
@@ -349,13 +426,13 @@ mod tests {
 
         let num_blobs: usize = rng.gen_range(1..16);
         let mut blobs: Vec<Blob> = (0..num_blobs)
-            .map(|_| generate_random_blob(&mut rng))
+            .map(|_| generate_random_blob(&mut rng, &kzg_settings))
             .collect();
 
         let commitments: Vec<Bytes48> = blobs
             .clone()
             .into_iter()
-            .map(|blob| KZGCommitment::blob_to_kzg_commitment(blob, &kzg_settings))
+            .map(|blob| KZGCommitment::blob_to_kzg_commitment(blob, &kzg_settings).unwrap())
             .map(|commitment| commitment.to_bytes())
             .collect();
 
@@ -372,7 +449,7 @@ mod tests {
             .unwrap_err();
         assert!(matches!(error, Error::MismatchLength(_)));
 
-        let incorrect_blob = generate_random_blob(&mut rng);
+        let incorrect_blob = generate_random_blob(&mut rng, &kzg_settings);
         blobs.push(incorrect_blob);
 
         assert!(!kzg_proof
@@ -382,15 +459,32 @@ mod tests {
 
     #[test]
     fn test_end_to_end() {
-        let trusted_setup_file = if cfg!(feature = "minimal-spec") {
-            PathBuf::from("../../src/trusted_setup_4.txt")
-        } else {
-            PathBuf::from("../../src/trusted_setup.txt")
-        };
-        test_simple(trusted_setup_file);
+        test_simple(PathBuf::from("../../src/trusted_setup.txt"));
+        test_simple(PathBuf::from("../../src/trusted_setup_4.txt"));
+    }
+
+    #[test]
+    fn test_blob_larger_than_setup() {
+        let mut rng = rand::thread_rng();
+        let mainnet =
+            KZGSettings::load_trusted_setup_file(PathBuf::from("../../src/trusted_setup.txt"))
+                .unwrap();
+        let minimal =
+            KZGSettings::load_trusted_setup_file(PathBuf::from("../../src/trusted_setup_4.txt"))
+                .unwrap();
+        assert_eq!(mainnet.field_elements_per_blob(), FIELD_ELEMENTS_PER_BLOB);
+        assert_eq!(minimal.field_elements_per_blob(), 4);
+
+        let blob = generate_random_blob(&mut rng, &mainnet);
+        let error = KZGCommitment::blob_to_kzg_commitment(blob, &minimal).unwrap_err();
+        assert!(matches!(error, Error::InvalidBytesLength(_)));
+        let error = KZGProof::compute_aggregate_kzg_proof(&[blob], &minimal).unwrap_err();
+        assert!(matches!(error, Error::InvalidBytesLength(_)));
+
+        let blob = Blob::from_bytes(&blob[..minimal.bytes_per_blob()]).unwrap();
+        assert!(KZGCommitment::blob_to_kzg_commitment(blob, &minimal).is_ok());
     }
 
-    #[cfg(not(feature = "minimal-spec"))]
     #[test]
     fn test_compute_agg_proof() {
         let trusted_setup_file = PathBuf::from("../../src/trusted_setup.txt");
@@ -433,7 +527,8 @@ mod tests {
             assert_eq!(proof.as_hex_string(), expected_proof);
 
             for (i, blob) in blobs.into_iter().enumerate() {
-                let commitment = KZGCommitment::blob_to_kzg_commitment(blob, &kzg_settings);
+                let commitment =
+                    KZGCommitment::blob_to_kzg_commitment(blob, &kzg_settings).unwrap();
                 assert_eq!(
                     commitment.as_hex_string().as_str(),
                     expected_commitments[i]
@@ -442,7 +537,6 @@ mod tests {
         }
     }
 
-    #[cfg(not(feature = "minimal-spec"))]
     #[test]
     fn test_verify_kzg_proof() {
         let trusted_setup_file = PathBuf::from("../../src/trusted_setup.txt");
@@ -17,10 +17,31 @@
 #include "blst.h"
 #include "c_kzg_4844.h"
 
-#include <inttypes.h>
+#ifdef STATIC_ROOTS_OF_UNITY
+#include "roots_of_unity.h"
+#endif
+
+#include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 // Macros
 ///////////////////////////////////////////////////////////////////////////////
@@ -109,7 +130,7 @@ static const g2_t G2_GENERATOR = {{{{
  * to create the roots of unity below. There are a lot of primitive roots:
  * https://crypto.stanford.edu/pbc/notes/numbertheory/gen.html
  */
-static const uint64_t SCALE2_ROOT_OF_UNITY[][4] = {
+STATIC const uint64_t SCALE2_ROOT_OF_UNITY[][4] = {
     {0x0000000000000001L, 0x0000000000000000L, 0x0000000000000000L, 0x0000000000000000L},
     {0xffffffff00000000L, 0x53bda402fffe5bfeL, 0x3339d80809a1d805L, 0x73eda753299d7d48L},
     {0x0001000000000000L, 0xec03000276030000L, 0x8d51ccce760304d0L, 0x0000000000000000L},
@@ -144,6 +165,9 @@ static const uint64_t SCALE2_ROOT_OF_UNITY[][4] = {
     {0x63e7cb4906ffc93fL, 0xf070bb00e28a193dL, 0xad1715b02e5713b5L, 0x4b5371495990693fL}
 };
 
+/** The number of G2 points kept from the trusted setup: `[1]` and `[s]`. */
+#define NUM_G2_VALUES 2
+
 /** The zero field element. */
 static const fr_t FR_ZERO = {0L, 0L, 0L, 0L};
 
@@ -154,8 +178,81 @@ static const fr_t FR_ONE = {0x00000001fffffffeL, 0x5884b7fa00034802L, 0x998c4fef
 // Memory Allocation Functions
 ///////////////////////////////////////////////////////////////////////////////
 
+/** The alignment of every allocation, enough for a cache line and the widest vector registers */
+#define KZG_ALLOC_ALIGNMENT 64
+
+/**
+ * The default `malloc_fn`, which uses the C library's aligned allocation.
+ *
+ * @param[in] ctx       Unused
+ * @param[in] size      The number of bytes to be allocated
+ * @param[in] alignment The alignment, a power of two that is a multiple of `sizeof(void *)`
+ * @return The allocated space, or NULL on failure
+ */
+static void *default_malloc(void *ctx, size_t size, size_t alignment) {
+    (void)ctx;
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    void *p;
+    return posix_memalign(&p, alignment, size) == 0 ? p : NULL;
+#endif
+}
+
+/**
+ * The default `calloc_fn`, which zeroes space from #default_malloc.
+ *
+ * @param[in] ctx       Unused
+ * @param[in] count     The number of elements to be allocated
+ * @param[in] size      The size of each element
+ * @param[in] alignment The alignment, a power of two that is a multiple of `sizeof(void *)`
+ * @return The allocated space, or NULL on failure
+ */
+static void *default_calloc(void *ctx, size_t count, size_t size, size_t alignment) {
+    if (size != 0 && count > SIZE_MAX / size) return NULL;
+    void *p = default_malloc(ctx, count * size, alignment);
+    if (p != NULL) memset(p, 0, count * size);
+    return p;
+}
+
 /**
- * Wrapped `malloc()` that reports failures to allocate.
+ * The default `free_fn`, which releases space from #default_malloc.
+ *
+ * @param[in] ctx Unused
+ * @param[in] p   The space to be released
+ */
+static void default_free(void *ctx, void *p) {
+    (void)ctx;
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+static const KZGAllocator DEFAULT_ALLOCATOR = {default_malloc, default_calloc, default_free, NULL};
+
+/** The allocator that all of the library's memory comes from */
+static const KZGAllocator *allocator = &DEFAULT_ALLOCATOR;
+
+/**
+ * Route all of the library's allocations to an allocator of the host's choosing.
+ *
+ * Every allocation, from the trusted setup tables to the temporary arrays of each call, goes through @p a. Each is
+ * aligned to 64 bytes.
+ *
+ * @remark This is process-wide. Call it before anything else in the library, and only once: memory must be released
+ * by the allocator that allocated it, so the allocator cannot change while any settings are loaded, or while any thread
+ * holds buffers that #release_kzg_thread_scratch has not released.
+ *
+ * @param[in] a The allocator, which must outlive its use, or NULL to go back to the C library's
+ */
+void set_kzg_allocator(const KZGAllocator *a) {
+    allocator = a != NULL ? a : &DEFAULT_ALLOCATOR;
+}
+
+/**
+ * Allocate aligned memory from the registered allocator, reporting failures to allocate.
  *
  * @param[out] x Pointer to the allocated space
  * @param[in]  n The number of bytes to be allocated
@@ -164,17 +261,107 @@ static const fr_t FR_ONE = {0x00000001fffffffeL, 0x5884b7fa00034802L, 0x998c4fef
  */
 static C_KZG_RET c_kzg_malloc(void **x, size_t n) {
     if (n > 0) {
-        *x = malloc(n);
+        *x = allocator->malloc_fn(allocator->ctx, n, KZG_ALLOC_ALIGNMENT);
+        return *x != NULL ? C_KZG_OK : C_KZG_MALLOC;
+    }
+    *x = NULL;
+    return C_KZG_OK;
+}
+
+/**
+ * Allocate aligned, zeroed memory for an array from the registered allocator, reporting failures to allocate.
+ *
+ * @param[out] x     Pointer to the allocated space
+ * @param[in]  count The number of elements to be allocated
+ * @param[in]  size  The size of each element
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+static C_KZG_RET c_kzg_calloc(void **x, size_t count, size_t size) {
+    if (count > 0 && size > 0) {
+        *x = allocator->calloc_fn(allocator->ctx, count, size, KZG_ALLOC_ALIGNMENT);
         return *x != NULL ? C_KZG_OK : C_KZG_MALLOC;
     }
     *x = NULL;
     return C_KZG_OK;
 }
 
+/**
+ * Release memory from #c_kzg_malloc or #c_kzg_calloc.
+ *
+ * @param[in] p The space to be released, may be NULL
+ */
+static void c_kzg_free(void *p) {
+    if (p != NULL) allocator->free_fn(allocator->ctx, p);
+}
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+/**
+ * Buffers for MSMs that are kept between calls on the same thread.
+ *
+ * Every commitment and proof is an MSM over the commitment key, which needs Pippenger scratch space, the scalars, and
+ * compacted copies of the non-zero terms. The sizes hardly vary from call to call, so each thread keeps the largest it
+ * has needed instead of allocating and freeing them every time.
+ */
+typedef struct {
+    void *scratch;           /**< Pippenger scratch space */
+    size_t scratch_size;     /**< The size of `scratch` in bytes */
+    blst_scalar *scalars;    /**< The scalars of an MSM */
+    size_t scalars_len;      /**< The number of `scalars` */
+    blst_p1_affine *points;  /**< The points of the non-zero terms of an MSM */
+    size_t points_len;       /**< The number of `points` */
+    fr_t *coeffs;            /**< The coefficients of the non-zero terms of an MSM */
+    size_t coeffs_len;       /**< The number of `coeffs` */
+} MsmScratch;
+
+static THREAD_LOCAL MsmScratch msm_scratch;
+
+/**
+ * Make sure that a cached buffer holds at least some number of bytes.
+ *
+ * The old contents are not kept.
+ *
+ * @param[in,out] buf  The buffer, replaced with a larger one if needed
+ * @param[in,out] size The size of @p buf in units of @p unit, updated if it grows
+ * @param[in]     n    The number of units needed
+ * @param[in]     unit The size of a unit in bytes
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_MALLOC  Memory allocation failed, and the buffer is now empty
+ */
+static C_KZG_RET reserve_scratch(void **buf, size_t *size, size_t n, size_t unit) {
+    C_KZG_RET ret;
+    if (n <= *size) return C_KZG_OK;
+    c_kzg_free(*buf);
+    *size = 0;
+    ret = c_kzg_malloc(buf, n * unit);
+    if (ret == C_KZG_OK) *size = n;
+    return ret;
+}
+
+/**
+ * Free the MSM buffers that the calling thread has kept between calls.
+ *
+ * Threads that have committed or proved hold on to a few hundred kilobytes of buffers until they exit. Threads that
+ * are pooled by the host should call this before they exit, and may call it at any other time to return the memory;
+ * the next call on the thread allocates the buffers again. Workers of #new_kzg_thread_pool do this themselves.
+ */
+void release_kzg_thread_scratch(void) {
+    c_kzg_free(msm_scratch.scratch);
+    c_kzg_free(msm_scratch.scalars);
+    c_kzg_free(msm_scratch.points);
+    c_kzg_free(msm_scratch.coeffs);
+    memset(&msm_scratch, 0, sizeof(msm_scratch));
+}
+
 /**
  * Allocate memory for an array of G1 group elements.
  *
- * @remark Free the space later using `free()`.
+ * @remark Free the space later using `c_kzg_free()`.
  *
  * @param[out] x Pointer to the allocated space
  * @param[in]  n The number of G1 elements to be allocated
@@ -188,7 +375,7 @@ static C_KZG_RET new_g1_array(g1_t **x, size_t n) {
 /**
  * Allocate memory for an array of G2 group elements.
  *
- * @remark Free the space later using `free()`.
+ * @remark Free the space later using `c_kzg_free()`.
  *
  * @param[out] x Pointer to the allocated space
  * @param[in]  n The number of G2 elements to be allocated
@@ -202,7 +389,7 @@ static C_KZG_RET new_g2_array(g2_t **x, size_t n) {
 /**
  * Allocate memory for an array of field elements.
  *
- * @remark Free the space later using `free()`.
+ * @remark Free the space later using `c_kzg_free()`.
  *
  * @param[out] x Pointer to the allocated space
  * @param[in]  n The number of field elements to be allocated
@@ -213,6 +400,21 @@ static C_KZG_RET new_fr_array(fr_t **x, size_t n) {
     return c_kzg_malloc((void **)x, n * sizeof **x);
 }
 
+/**
+ * Allocate memory for a polynomial.
+ *
+ * A polynomial is as large as a blob, so it goes on the heap rather than the stack.
+ *
+ * @remark Free the space later using `c_kzg_free()`.
+ *
+ * @param[out] x Pointer to the allocated space
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+static C_KZG_RET new_polynomial(Polynomial **x) {
+    return c_kzg_malloc((void **)x, sizeof **x);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Helper Functions
 ///////////////////////////////////////////////////////////////////////////////
@@ -247,6 +449,19 @@ static bool fr_is_one(const fr_t *p) {
     return a[0] == 1 && a[1] == 0 && a[2] == 0 && a[3] == 0;
 }
 
+/**
+ * Test whether the operand is zero in the finite field.
+ *
+ * @remark Zero is the only value whose Montgomery representation is all zero limbs, so no conversion is needed.
+ *
+ * @param p The field element to be checked
+ * @retval true  The element is zero
+ * @retval false The element is not zero
+ */
+static bool fr_is_zero(const fr_t *p) {
+    return (p->l[0] | p->l[1] | p->l[2] | p->l[3]) == 0;
+}
+
 /**
  * Test whether two field elements are equal.
  *
@@ -262,19 +477,6 @@ static bool fr_equal(const fr_t *aa, const fr_t *bb) {
     return a[0] == b[0] && a[1] == b[1] && a[2] == b[2] && a[3] == b[3];
 }
 
-/**
- * Divide a field element by another.
- *
- * @param[out] out @p a divided by @p b in the field
- * @param[in]  a   The dividend
- * @param[in]  b   The divisor
- */
-static void fr_div(fr_t *out, const fr_t *a, const fr_t *b) {
-    blst_fr tmp;
-    blst_fr_eucl_inverse(&tmp, b);
-    blst_fr_mul(out, a, &tmp);
-}
-
 /**
  * Exponentiation of a field element.
  *
@@ -343,10 +545,24 @@ static C_KZG_RET fr_batch_inv(fr_t *out, const fr_t *a, size_t len) {
     out[0] = inv;
 
 out:
-    free(prod);
+    c_kzg_free(prod);
     return ret;
 }
 
+/**
+ * Count the number of significant bits in a scalar.
+ *
+ * @param[in] s The scalar, in little-endian byte order
+ * @return The index of the highest set bit plus one, or zero if @p s is zero
+ */
+static size_t scalar_bit_length(const blst_scalar *s) {
+    // Count the number of bytes, then the bits within the top byte.
+    size_t i = sizeof(blst_scalar);
+    while (i && !s->b[i - 1]) --i;
+    if (i == 0) return 0;
+    return 8 * i - 7 + log_2_byte(s->b[i - 1]);
+}
+
 /**
  * Multiply a G1 group element by a field element.
  *
@@ -360,16 +576,13 @@ static void g1_mul(g1_t *out, const g1_t *a, const fr_t *b) {
     blst_scalar s;
     blst_scalar_from_fr(&s, b);
 
-    // Count the number of bytes to be multiplied.
-    int i = sizeof(blst_scalar);
-    while (i && !s.b[i - 1]) --i;
-    if (i == 0) {
+    size_t nbits = scalar_bit_length(&s);
+    if (nbits == 0) {
         *out = G1_IDENTITY;
-    } else if (i == 1 && s.b[0] == 1) {
+    } else if (nbits == 1) {
         *out = *a;
     } else {
-        // Count the number of bits to be multiplied.
-        blst_p1_mult(out, a, s.b, 8 * i - 7 + log_2_byte(s.b[i - 1]));
+        blst_p1_mult(out, a, s.b, nbits);
     }
 }
 
@@ -587,6 +800,94 @@ static C_KZG_RET bit_reversal_permutation(void *values, size_t size, uint64_t n)
     return C_KZG_OK;
 }
 
+/**
+ * Look up a power of the root of unity in ascending order.
+ *
+ * Only the bit-reversal permuted powers are stored, so this undoes the permutation on the index.
+ *
+ * @param[in] fs The FFT settings containing the roots of unity
+ * @param[in] i  The power to look up, less than `fs->max_width`
+ * @return The root of unity raised to the power @p i
+ */
+static const fr_t *expanded_root_of_unity(const FFTSettings *fs, uint64_t i) {
+    int unused_bit_len = 32 - log2_pow2(fs->max_width);
+    return &fs->roots_of_unity[reverse_bits(i) >> unused_bit_len];
+}
+
+/**
+ * Pick the copy of the settings on the calling thread's NUMA node.
+ *
+ * See #place_trusted_setup. The node lookup is a system call, which is negligible next to the MSMs that follow.
+ *
+ * @param[in] s The settings passed to a public function
+ * @return The replica local to the calling thread, or @p s itself if there is none
+ */
+static const KZGSettings *local_settings(const KZGSettings *s) {
+#ifdef __linux__
+    unsigned int node;
+    if (s->replicas != NULL && syscall(SYS_getcpu, NULL, &node, NULL) == 0 && node < s->num_replicas) {
+        return &s->replicas[node];
+    }
+#endif
+    return s;
+}
+
+/**
+ * The number of field elements in a blob for the preset of the given settings.
+ *
+ * This is the number of G1 points in the trusted setup. It is at most `FIELD_ELEMENTS_PER_BLOB`, the largest preset
+ * that the library was built for.
+ *
+ * @param[in] s The settings
+ * @return The number of field elements per blob
+ */
+static uint64_t blob_width(const KZGSettings *s) {
+    return s->fs->max_width;
+}
+
+/**
+ * Find a blob in an array of blobs of the preset of the given settings.
+ *
+ * Blobs are packed at the preset's size, which is smaller than `sizeof(Blob)` for presets below the largest.
+ *
+ * @param[in] blobs The array of blobs
+ * @param[in] i     The index of the blob
+ * @param[in] s     The settings
+ * @return The blob at index @p i
+ */
+static const Blob *blob_at(const Blob *blobs, size_t i, const KZGSettings *s) {
+    return (const Blob *)&blobs->bytes[i * blob_width(s) * BYTES_PER_FIELD_ELEMENT];
+}
+
+/**
+ * Run a parallel loop on the executor of some settings, or on the calling thread if they have none.
+ *
+ * @param[in] s   The settings
+ * @param[in] fn  The function to call with each index
+ * @param[in] arg The first argument to @p fn
+ * @param[in] n   The number of indices
+ */
+static void run_parallel(const KZGSettings *s, kzg_task_fn fn, void *arg, size_t n) {
+    if (s->executor != NULL && n > 1) {
+        s->executor->parallel_for(s->executor->ctx, fn, arg, n);
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        fn(arg, i);
+    }
+}
+
+/**
+ * The number of tasks that are worth splitting work into for the executor of some settings.
+ *
+ * @param[in] s The settings
+ * @return The executor's thread count, or 1 if there is no executor
+ */
+static size_t parallelism(const KZGSettings *s) {
+    if (s->executor == NULL || s->executor->num_threads == 0) return 1;
+    return s->executor->num_threads;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // BLS12-381 Helper Functions
 ///////////////////////////////////////////////////////////////////////////////
@@ -682,12 +983,13 @@ static C_KZG_RET bytes_to_kzg_proof(g1_t *out, const Bytes48 *b) {
  *
  * @param[out] p    The output polynomial (array of field elements)
  * @param[in]  blob The blob (an array of bytes)
+ * @param[in]  s    The settings, which determine the size of the blob
  * @retval C_KZG_OK      Deserialization successful
  * @retval C_KZG_BADARGS Invalid input bytes
  */
-STATIC C_KZG_RET blob_to_polynomial(Polynomial *p, const Blob *blob) {
+STATIC C_KZG_RET blob_to_polynomial(Polynomial *p, const Blob *blob, const KZGSettings *s) {
     C_KZG_RET ret;
-    for (size_t i = 0; i < FIELD_ELEMENTS_PER_BLOB; i++) {
+    for (size_t i = 0; i < blob_width(s); i++) {
         ret = bytes_to_bls_field(&p->evals[i], (Bytes32 *)&blob->bytes[i * BYTES_PER_FIELD_ELEMENT]);
         if (ret != C_KZG_OK) return ret;
     }
@@ -707,18 +1009,20 @@ STATIC void compute_powers(fr_t *out, fr_t *x, uint64_t n);
  * @param[in]  polys              The array of polynomials
  * @param[in]  comms              The array of commitments
  * @param[in]  n                  The number of polynomials and commitments
+ * @param[in]  width              The number of field elements per blob
  * @retval C_KZG_OK     Challenge computation successful
  * @retval C_KZG_MALLOC Memory allocation failed
  */
 static C_KZG_RET compute_challenges(fr_t *eval_challenge_out, fr_t *r_powers_out,
-                                    const Polynomial *polys, const g1_t *comms, uint64_t n) {
+                                    const Polynomial *polys, const g1_t *comms, uint64_t n, uint64_t width) {
     size_t i;
     uint64_t j;
 
     // len(FIAT_SHAMIR_PROTOCOL_DOMAIN) + 8 + 8 + n blobs + n commitments
-    size_t input_size = 32 + (n * BYTES_PER_BLOB) + (n * 48);
-    uint8_t *bytes = calloc(input_size, sizeof(uint8_t));
-    if (bytes == NULL) return C_KZG_MALLOC;
+    size_t input_size = 32 + (n * width * BYTES_PER_FIELD_ELEMENT) + (n * 48);
+    uint8_t *bytes = NULL;
+    C_KZG_RET ret = c_kzg_calloc((void **)&bytes, input_size, sizeof(uint8_t));
+    if (ret != C_KZG_OK) return ret;
 
     /* Pointer tracking `bytes` for writing on top of it */
     uint8_t *offset = bytes;
@@ -726,14 +1030,14 @@ static C_KZG_RET compute_challenges(fr_t *eval_challenge_out, fr_t *r_powers_out
     /* Copy domain separator */
     memcpy(offset, FIAT_SHAMIR_PROTOCOL_DOMAIN, 16);
     offset += 16;
-    bytes_from_uint64(offset, FIELD_ELEMENTS_PER_BLOB);
+    bytes_from_uint64(offset, width);
     offset += 8;
     bytes_from_uint64(offset, n);
     offset += 8;
 
     /* Copy polynomials */
     for (i = 0; i < n; i++) {
-      for (j = 0; j < FIELD_ELEMENTS_PER_BLOB; j++) {
+      for (j = 0; j < width; j++) {
         bytes_from_bls_field((Bytes32 *)offset, &polys[i].evals[j]);
         offset += BYTES_PER_FIELD_ELEMENT;
       }
@@ -769,19 +1073,21 @@ static C_KZG_RET compute_challenges(fr_t *eval_challenge_out, fr_t *r_powers_out
     blst_sha256(eval_challenge.bytes, hash_input, 33);
     hash_to_bls_field(eval_challenge_out, &eval_challenge);
 
-    free(bytes);
+    c_kzg_free(bytes);
     return C_KZG_OK;
 }
 
 /**
- * Calculate a linear combination of G1 group elements.
+ * Calculate a linear combination of G1 group elements given in affine form.
  *
  * Calculates `[coeffs_0]p_0 + [coeffs_1]p_1 + ... + [coeffs_n]p_n` where `n` is `len - 1`.
  *
  * @param[out] out    The resulting sum-product
- * @param[in]  p      Array of G1 group elements, length @p len
+ * @param[in]  p      Array of affine G1 group elements, length @p len
  * @param[in]  coeffs Array of field elements, length @p len
  * @param[in]  len    The number of group/field elements
+ * @retval C_KZG_OK     All is well
+ * @retval C_KZG_MALLOC Memory allocation failed
  *
  * For the benefit of future generations (since Blst has no documentation to speak of),
  * there are two ways to pass the arrays of scalars and points into `blst_p1s_mult_pippenger()`.
@@ -793,54 +1099,222 @@ static C_KZG_RET compute_challenges(fr_t *eval_challenge_out, fr_t *r_powers_out
  *
  * We do the second of these to save memory here.
  */
-static C_KZG_RET g1_lincomb(g1_t *out, const g1_t *p, const fr_t *coeffs, const uint64_t len) {
-    C_KZG_RET ret = C_KZG_MALLOC;
-    void *scratch = NULL;
-    blst_p1_affine *p_affine = NULL;
-    blst_scalar *scalars = NULL;
+static C_KZG_RET g1_lincomb_affine(g1_t *out, const blst_p1_affine *p, const fr_t *coeffs, const uint64_t len) {
+    C_KZG_RET ret;
 
     // Tunable parameter: must be at least 2 since Blst fails for 0 or 1
     if (len < 8) {
         // Direct approach
-        g1_t tmp;
+        g1_t point, tmp;
         *out = G1_IDENTITY;
         for (uint64_t i = 0; i < len; i++) {
-            g1_mul(&tmp, &p[i], &coeffs[i]);
+            blst_p1_from_affine(&point, &p[i]);
+            g1_mul(&tmp, &point, &coeffs[i]);
             blst_p1_add_or_double(out, out, &tmp);
         }
     } else {
         // Blst's implementation of the Pippenger method
-        scratch = malloc(blst_p1s_mult_pippenger_scratch_sizeof(len));
-        if (scratch == NULL) goto out;
-        p_affine = malloc(len * sizeof(blst_p1_affine));
-        if (p_affine == NULL) goto out;
-        scalars = malloc(len * sizeof(blst_scalar));
-        if (scalars == NULL) goto out;
-
-        // Transform the points to affine representation
-        const blst_p1 *p_arg[2] = {p, NULL};
-        blst_p1s_to_affine(p_affine, p_arg, len);
-
-        // Transform the field elements to 256-bit scalars
-        for (int i = 0; i < len; i++) {
+        // The buffers are cached per thread, see #release_kzg_thread_scratch
+        MsmScratch *cache = &msm_scratch;
+        ret = reserve_scratch(&cache->scratch, &cache->scratch_size, blst_p1s_mult_pippenger_scratch_sizeof(len), 1);
+        if (ret != C_KZG_OK) return ret;
+        ret = reserve_scratch((void **)&cache->scalars, &cache->scalars_len, len, sizeof(blst_scalar));
+        if (ret != C_KZG_OK) return ret;
+        blst_scalar *scalars = cache->scalars;
+
+        // Transform the field elements to 256-bit scalars, keeping track of the widest one
+        size_t nbits = 0;
+        for (uint64_t i = 0; i < len; i++) {
             blst_scalar_from_fr(&scalars[i], &coeffs[i]);
+            size_t bits = scalar_bit_length(&scalars[i]);
+            if (bits > nbits) nbits = bits;
+        }
+
+        if (nbits == 0) {
+            *out = G1_IDENTITY;
+            return C_KZG_OK;
+        }
+
+        // Pippenger needs one window pass per chunk of `nbits`, so narrow scalars are cheaper. Blobs packed with 31
+        // bytes per field element, for example, never use more than 248 bits. Blst reads contiguous scalars with a
+        // stride of `(nbits + 7) / 8` bytes, so pack them down to that width first. Bytes are little-endian, so this
+        // only drops leading zeros, and each move lands at or before its source.
+        size_t nbytes = (nbits + 7) / 8;
+        if (nbytes < sizeof(blst_scalar)) {
+            byte *packed = (byte *)scalars;
+            for (uint64_t i = 1; i < len; i++) {
+                memmove(&packed[i * nbytes], scalars[i].b, nbytes);
+            }
         }
 
         // Call the Pippenger implementation
         const byte *scalars_arg[2] = {(byte *)scalars, NULL};
-        const blst_p1_affine *points_arg[2] = {p_affine, NULL};
-        blst_p1s_mult_pippenger(out, points_arg, len, scalars_arg, 256, scratch);
+        const blst_p1_affine *points_arg[2] = {p, NULL};
+        blst_p1s_mult_pippenger(out, points_arg, len, scalars_arg, nbits, cache->scratch);
     }
 
-    ret = C_KZG_OK;
+    return C_KZG_OK;
+}
+
+/**
+ * Calculate a linear combination of G1 group elements.
+ *
+ * Calculates `[coeffs_0]p_0 + [coeffs_1]p_1 + ... + [coeffs_n]p_n` where `n` is `len - 1`.
+ *
+ * @remark Pippenger works on affine points, so larger inputs are converted first. Prefer #g1_lincomb_affine for points
+ * that are reused, such as the commitment key.
+ *
+ * @param[out] out    The resulting sum-product
+ * @param[in]  p      Array of G1 group elements, length @p len
+ * @param[in]  coeffs Array of field elements, length @p len
+ * @param[in]  len    The number of group/field elements
+ * @retval C_KZG_OK     All is well
+ * @retval C_KZG_MALLOC Memory allocation failed
+ */
+static C_KZG_RET g1_lincomb(g1_t *out, const g1_t *p, const fr_t *coeffs, const uint64_t len) {
+    C_KZG_RET ret;
+    blst_p1_affine *p_affine = NULL;
+
+    if (len < 8) {
+        // Direct approach, which needs no conversion
+        g1_t tmp;
+        *out = G1_IDENTITY;
+        for (uint64_t i = 0; i < len; i++) {
+            g1_mul(&tmp, &p[i], &coeffs[i]);
+            blst_p1_add_or_double(out, out, &tmp);
+        }
+        return C_KZG_OK;
+    }
+
+    ret = c_kzg_malloc((void **)&p_affine, len * sizeof(blst_p1_affine));
+    if (ret != C_KZG_OK) goto out;
+
+    // Transform the points to affine representation
+    const blst_p1 *p_arg[2] = {p, NULL};
+    blst_p1s_to_affine(p_affine, p_arg, len);
+
+    ret = g1_lincomb_affine(out, p_affine, coeffs, len);
 
 out:
-    free(scratch);
-    free(p_affine);
-    free(scalars);
+    c_kzg_free(p_affine);
     return ret;
 }
 
+/** The fewest points an MSM is split into chunks of, below which Pippenger loses more than threads gain */
+#define MIN_MSM_CHUNK 512
+/** The most chunks an MSM is split into */
+#define MAX_MSM_CHUNKS 64
+
+/**
+ * The chunks of an MSM split by #g1_lincomb_parallel.
+ */
+typedef struct {
+    g1_t partials[MAX_MSM_CHUNKS];  /**< The sum-product of each chunk */
+    C_KZG_RET rets[MAX_MSM_CHUNKS]; /**< The result of each chunk */
+    const blst_p1_affine *p;        /**< All the points */
+    const fr_t *coeffs;             /**< All the coefficients */
+    uint64_t len;                   /**< The number of points and coefficients */
+    size_t chunks;                  /**< The number of chunks */
+} LincombTask;
+
+/**
+ * Compute the sum-product of one chunk of an MSM.
+ *
+ * @param[in,out] arg The #LincombTask
+ * @param[in]     i   The chunk
+ */
+static void lincomb_chunk(void *arg, size_t i) {
+    LincombTask *t = arg;
+    uint64_t start = t->len * i / t->chunks, end = t->len * (i + 1) / t->chunks;
+    t->rets[i] = g1_lincomb_affine(&t->partials[i], &t->p[start], &t->coeffs[start], end - start);
+}
+
+/**
+ * Calculate a linear combination of affine G1 group elements on the executor of some settings.
+ *
+ * Large MSMs are split into contiguous chunks that run as separate Pippenger instances, and the partial sums are
+ * added at the end. Without an executor this is just #g1_lincomb_affine.
+ *
+ * @param[out] out    The resulting sum-product
+ * @param[in]  p      Array of affine G1 group elements, length @p len
+ * @param[in]  coeffs Array of field elements, length @p len
+ * @param[in]  len    The number of group/field elements
+ * @param[in]  s      The settings whose executor to use
+ * @retval C_KZG_OK     All is well
+ * @retval C_KZG_MALLOC Memory allocation failed
+ */
+static C_KZG_RET g1_lincomb_parallel(g1_t *out, const blst_p1_affine *p, const fr_t *coeffs, const uint64_t len,
+                                     const KZGSettings *s) {
+    LincombTask t;
+    size_t i;
+
+    t.chunks = parallelism(s);
+    if (t.chunks > len / MIN_MSM_CHUNK) t.chunks = len / MIN_MSM_CHUNK;
+    if (t.chunks > MAX_MSM_CHUNKS) t.chunks = MAX_MSM_CHUNKS;
+    if (t.chunks <= 1) return g1_lincomb_affine(out, p, coeffs, len);
+
+    t.p = p;
+    t.coeffs = coeffs;
+    t.len = len;
+    run_parallel(s, lincomb_chunk, &t, t.chunks);
+
+    *out = G1_IDENTITY;
+    for (i = 0; i < t.chunks; i++) {
+        if (t.rets[i] != C_KZG_OK) return t.rets[i];
+        blst_p1_add_or_double(out, out, &t.partials[i]);
+    }
+    return C_KZG_OK;
+}
+
+/**
+ * Calculate a linear combination of affine G1 group elements, skipping the terms with a zero coefficient.
+ *
+ * Blobs are usually zero-padded, so a large share of the coefficients we commit to can be zero. Those terms contribute
+ * nothing to the sum, so the non-zero (point, coefficient) pairs are compacted before being handed to
+ * #g1_lincomb_affine. If only a handful of terms remain, that falls back to direct summation rather than Pippenger.
+ *
+ * @param[out] out         The resulting sum-product
+ * @param[out] nonzero_out The number of non-zero coefficients that were observed, may be NULL
+ * @param[in]  p           Array of affine G1 group elements, length @p len
+ * @param[in]  coeffs      Array of field elements, length @p len
+ * @param[in]  len         The number of group/field elements
+ * @param[in]  s           The settings whose executor to use
+ * @retval C_KZG_OK     All is well
+ * @retval C_KZG_MALLOC Memory allocation failed
+ */
+static C_KZG_RET g1_lincomb_sparse(g1_t *out, uint64_t *nonzero_out, const blst_p1_affine *p, const fr_t *coeffs,
+                                   const uint64_t len, const KZGSettings *s) {
+    C_KZG_RET ret;
+    MsmScratch *cache = &msm_scratch;
+    uint64_t i, nonzero = 0;
+
+    for (i = 0; i < len; i++) {
+        if (!fr_is_zero(&coeffs[i])) nonzero++;
+    }
+    if (nonzero_out != NULL) *nonzero_out = nonzero;
+
+    // Nothing to skip, so avoid the copies
+    if (nonzero == len) return g1_lincomb_parallel(out, p, coeffs, len, s);
+
+    // The compacted terms are cached per thread, see #release_kzg_thread_scratch
+    ret = reserve_scratch((void **)&cache->points, &cache->points_len, nonzero, sizeof(blst_p1_affine));
+    if (ret != C_KZG_OK) return ret;
+    ret = reserve_scratch((void **)&cache->coeffs, &cache->coeffs_len, nonzero, sizeof(fr_t));
+    if (ret != C_KZG_OK) return ret;
+    blst_p1_affine *p_compact = cache->points;
+    fr_t *coeffs_compact = cache->coeffs;
+
+    nonzero = 0;
+    for (i = 0; i < len; i++) {
+        if (fr_is_zero(&coeffs[i])) continue;
+        p_compact[nonzero] = p[i];
+        coeffs_compact[nonzero] = coeffs[i];
+        nonzero++;
+    }
+
+    return g1_lincomb_parallel(out, p_compact, coeffs_compact, nonzero, s);
+}
+
 /**
  * Given an array of polynomials, interpret it as a 2D matrix and compute the linear combination
  * of each column with a set of scalars: return the resulting polynomial.
@@ -851,14 +1325,15 @@ out:
  * @param[in]  vectors The array of polynomials to be combined
  * @param[in]  scalars The array of scalars to multiply the polynomials with
  * @param[in]  n       The number of polynomials and scalars
+ * @param[in]  width   The number of evaluations in each polynomial
  */
-static void poly_lincomb(Polynomial *out, const Polynomial *vectors, const fr_t *scalars, uint64_t n) {
+static void poly_lincomb(Polynomial *out, const Polynomial *vectors, const fr_t *scalars, uint64_t n, uint64_t width) {
     fr_t tmp;
     uint64_t i, j;
-    for (j = 0; j < FIELD_ELEMENTS_PER_BLOB; j++)
+    for (j = 0; j < width; j++)
         out->evals[j] = FR_ZERO;
     for (i = 0; i < n; i++) {
-        for (j = 0; j < FIELD_ELEMENTS_PER_BLOB; j++) {
+        for (j = 0; j < width; j++) {
             blst_fr_mul(&tmp, &scalars[i], &vectors[i].evals[j]);
             blst_fr_add(&out->evals[j], &out->evals[j], &tmp);
         }
@@ -887,30 +1362,115 @@ STATIC void compute_powers(fr_t *out, fr_t *x, uint64_t n) {
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
- * Evaluate a polynomial in evaluation form at a given point.
+ * Compute the barycentric weights of a polynomial in evaluation form.
  *
- * @param[out] out The result of the evaluation
- * @param[in]  p   The polynomial in evaluation form
- * @param[in]  x   The point to evaluate the polynomial at
- * @param[in]  s   The settings struct containing the roots of unity
- * @retval C_KZG_OK Evaluation successful
- * @retval C_KZG_MALLOC Memory allocation failed
+ * These are `p_i * ω_i / N`, which depend only on the polynomial, so they can be shared across evaluation points.
+ *
+ * @param[out] weights The weights, one per field element of a blob
+ * @param[in]  p       The polynomial in evaluation form
+ * @param[in]  s       The settings struct containing the roots of unity
  */
-STATIC C_KZG_RET evaluate_polynomial_in_evaluation_form(fr_t *out, const Polynomial *p, const fr_t *x, const KZGSettings *s) {
-    C_KZG_RET ret;
+static void compute_barycentric_weights(fr_t *weights, const Polynomial *p, const KZGSettings *s) {
+    const fr_t *roots_of_unity_div_width = s->fs->roots_of_unity_div_width;
+    for (uint64_t i = 0; i < blob_width(s); i++) {
+        blst_fr_mul(&weights[i], &p->evals[i], &roots_of_unity_div_width[i]);
+    }
+}
+
+/**
+ * Evaluate a polynomial at a point outside the domain, given its barycentric weights and the inverted denominators.
+ *
+ * Computes `(x^N - 1) * Σ weights_i / (x - ω_i)`, which is an inner product of the weights with the inverses.
+ *
+ * @param[out] out      The result of the evaluation
+ * @param[in]  weights  The barycentric weights from #compute_barycentric_weights, length @p width
+ * @param[in]  x        The point to evaluate the polynomial at, which must not be a root of unity
+ * @param[in]  inverses The inverses of `x - ω_i` for each root of unity `ω_i`, length @p width
+ * @param[in]  width    The number of roots of unity
+ */
+static void evaluate_barycentric_weights(fr_t *out, const fr_t *weights, const fr_t *x, const fr_t *inverses,
+                                         uint64_t width) {
     fr_t tmp;
-    fr_t *inverses_in = NULL;
-    fr_t *inverses = NULL;
-    uint64_t i;
-    const fr_t *roots_of_unity = s->fs->roots_of_unity;
 
-    ret = new_fr_array(&inverses_in, FIELD_ELEMENTS_PER_BLOB);
-    if (ret != C_KZG_OK) goto out;
-    ret = new_fr_array(&inverses, FIELD_ELEMENTS_PER_BLOB);
-    if (ret != C_KZG_OK) goto out;
+    *out = FR_ZERO;
+    for (uint64_t i = 0; i < width; i++) {
+        blst_fr_mul(&tmp, &weights[i], &inverses[i]);
+        blst_fr_add(out, out, &tmp);
+    }
+    fr_pow(&tmp, x, width);
+    blst_fr_sub(&tmp, &tmp, &FR_ONE);
+    blst_fr_mul(out, out, &tmp);
+}
 
-    for (i = 0; i < FIELD_ELEMENTS_PER_BLOB; i++) {
-        if (fr_equal(x, &roots_of_unity[i])) {
+/**
+ * Invert the differences between many points and every root of unity in a single batch inversion.
+ *
+ * Row `j` of @p inverses holds the inverses of `x_j - ω_i`. A point that equals one of the roots of unity has no such
+ * inverse; its row is left undefined and its position in the domain is reported instead.
+ *
+ * @param[out] inverses     The inverses, @p k rows of one per field element of a blob
+ * @param[out] domain_index For each point, zero if it lies outside the domain, else one more than its index
+ * @param[in]  xs           Array of @p k points
+ * @param[in]  k            The number of points, must be at least one
+ * @param[in]  s            The settings struct containing the roots of unity
+ * @retval C_KZG_OK     All is well
+ * @retval C_KZG_MALLOC Memory allocation failed
+ */
+static C_KZG_RET batch_inverse_differences(fr_t *inverses, uint64_t *domain_index, const fr_t *xs, size_t k,
+                                           const KZGSettings *s) {
+    C_KZG_RET ret;
+    fr_t *inverses_in = NULL;
+    const fr_t *roots_of_unity = s->fs->roots_of_unity;
+    uint64_t width = blob_width(s);
+    uint64_t i, j;
+
+    ret = new_fr_array(&inverses_in, k * width);
+    if (ret != C_KZG_OK) goto out;
+
+    for (j = 0; j < k; j++) {
+        domain_index[j] = 0;
+        for (i = 0; i < width; i++) {
+            fr_t *d = &inverses_in[j * width + i];
+            blst_fr_sub(d, &xs[j], &roots_of_unity[i]);
+            if (fr_is_zero(d)) {
+                domain_index[j] = i + 1;
+                *d = FR_ONE;
+            }
+        }
+    }
+
+    ret = fr_batch_inv(inverses, inverses_in, k * width);
+
+out:
+    c_kzg_free(inverses_in);
+    return ret;
+}
+
+/**
+ * Evaluate a polynomial in evaluation form at a given point.
+ *
+ * @param[out] out The result of the evaluation
+ * @param[in]  p   The polynomial in evaluation form
+ * @param[in]  x   The point to evaluate the polynomial at
+ * @param[in]  s   The settings struct containing the roots of unity
+ * @retval C_KZG_OK Evaluation successful
+ * @retval C_KZG_MALLOC Memory allocation failed
+ */
+STATIC C_KZG_RET evaluate_polynomial_in_evaluation_form(fr_t *out, const Polynomial *p, const fr_t *x, const KZGSettings *s) {
+    C_KZG_RET ret;
+    fr_t *inverses_in = NULL;
+    fr_t *inverses = NULL;
+    uint64_t i;
+    uint64_t width = blob_width(s);
+    const fr_t *roots_of_unity = s->fs->roots_of_unity;
+
+    ret = new_fr_array(&inverses_in, width);
+    if (ret != C_KZG_OK) goto out;
+    ret = new_fr_array(&inverses, width);
+    if (ret != C_KZG_OK) goto out;
+
+    for (i = 0; i < width; i++) {
+        if (fr_equal(x, &roots_of_unity[i])) {
             *out = p->evals[i];
             ret = C_KZG_OK;
             goto out;
@@ -918,24 +1478,88 @@ STATIC C_KZG_RET evaluate_polynomial_in_evaluation_form(fr_t *out, const Polynom
         blst_fr_sub(&inverses_in[i], x, &roots_of_unity[i]);
     }
 
-    ret = fr_batch_inv(inverses, inverses_in, FIELD_ELEMENTS_PER_BLOB);
+    ret = fr_batch_inv(inverses, inverses_in, width);
     if (ret != C_KZG_OK) goto out;
 
-    *out = FR_ZERO;
-    for (i = 0; i < FIELD_ELEMENTS_PER_BLOB; i++) {
-        blst_fr_mul(&tmp, &inverses[i], &roots_of_unity[i]);
-        blst_fr_mul(&tmp, &tmp, &p->evals[i]);
-        blst_fr_add(out, out, &tmp);
+    /* The denominators are no longer needed, so reuse their space for the weights */
+    compute_barycentric_weights(inverses_in, p, s);
+    evaluate_barycentric_weights(out, inverses_in, x, inverses, width);
+
+out:
+    c_kzg_free(inverses_in);
+    c_kzg_free(inverses);
+    return ret;
+}
+
+/**
+ * Evaluate a blob at multiple points.
+ *
+ * The blob is deserialized once and its barycentric weights are shared across all points. The denominators for every
+ * point are inverted together in a single batch inversion, so each point costs one inner product.
+ *
+ * @param[out] ys       Array of @p k evaluation results
+ * @param[in]  blob     The blob (polynomial) to evaluate
+ * @param[in]  xs_bytes Array of @p k points to evaluate the blob at
+ * @param[in]  k        The number of points
+ * @param[in]  s        The settings struct containing the roots of unity
+ * @retval C_KZG_OK      Evaluation successful
+ * @retval C_KZG_BADARGS Invalid input blob or point
+ * @retval C_KZG_MALLOC  Memory allocation failed
+ */
+C_KZG_RET evaluate_blob_at_points(Bytes32 *ys, const Blob *blob, const Bytes32 *xs_bytes, size_t k,
+                                  const KZGSettings *s) {
+    C_KZG_RET ret;
+    Polynomial *polynomial = NULL;
+    fr_t *xs = NULL;
+    fr_t *weights = NULL;
+    fr_t *inverses = NULL;
+    uint64_t *domain_index = NULL;
+    uint64_t width, j;
+
+    s = local_settings(s);
+    width = blob_width(s);
+
+    ret = new_polynomial(&polynomial);
+    if (ret != C_KZG_OK) goto out;
+    ret = blob_to_polynomial(polynomial, blob, s);
+    if (ret != C_KZG_OK) goto out;
+    if (k == 0) goto out;
+
+    ret = new_fr_array(&xs, k);
+    if (ret != C_KZG_OK) goto out;
+    ret = new_fr_array(&weights, width);
+    if (ret != C_KZG_OK) goto out;
+    ret = new_fr_array(&inverses, k * width);
+    if (ret != C_KZG_OK) goto out;
+    ret = c_kzg_malloc((void **)&domain_index, k * sizeof *domain_index);
+    if (ret != C_KZG_OK) goto out;
+
+    for (j = 0; j < k; j++) {
+        ret = bytes_to_bls_field(&xs[j], &xs_bytes[j]);
+        if (ret != C_KZG_OK) goto out;
+    }
+
+    ret = batch_inverse_differences(inverses, domain_index, xs, k, s);
+    if (ret != C_KZG_OK) goto out;
+
+    compute_barycentric_weights(weights, polynomial, s);
+
+    for (j = 0; j < k; j++) {
+        fr_t y;
+        if (domain_index[j]) {
+            y = polynomial->evals[domain_index[j] - 1];
+        } else {
+            evaluate_barycentric_weights(&y, weights, &xs[j], &inverses[j * width], width);
+        }
+        bytes_from_bls_field(&ys[j], &y);
     }
-    fr_from_uint64(&tmp, FIELD_ELEMENTS_PER_BLOB);
-    fr_div(out, out, &tmp);
-    fr_pow(&tmp, x, FIELD_ELEMENTS_PER_BLOB);
-    blst_fr_sub(&tmp, &tmp, &FR_ONE);
-    blst_fr_mul(out, out, &tmp);
 
 out:
-    free(inverses_in);
-    free(inverses);
+    c_kzg_free(polynomial);
+    c_kzg_free(xs);
+    c_kzg_free(weights);
+    c_kzg_free(inverses);
+    c_kzg_free(domain_index);
     return ret;
 }
 
@@ -946,14 +1570,17 @@ out:
 /**
  * Compute a KZG commitment from a polynomial.
  *
- * @param[out] out The resulting commitment
- * @param[in]  p   The polynomial to commit to
- * @param[in]  s   The settings struct containing the commitment key (i.e. the trusted setup)
+ * Zero evaluations, e.g. the padding at the end of a partially filled blob, are skipped.
+ *
+ * @param[out] out         The resulting commitment
+ * @param[out] nonzero_out The number of non-zero evaluations that were committed to, may be NULL
+ * @param[in]  p           The polynomial to commit to
+ * @param[in]  s           The settings struct containing the commitment key (i.e. the trusted setup)
  * @retval C_KZG_OK     Commitment computation successful
  * @retval C_KZG_MALLOC Memory allocation failed
  */
-static C_KZG_RET poly_to_kzg_commitment(g1_t *out, const Polynomial *p, const KZGSettings *s) {
-    return g1_lincomb(out, s->g1_values, (const fr_t *)(&p->evals), FIELD_ELEMENTS_PER_BLOB);
+STATIC C_KZG_RET poly_to_kzg_commitment(g1_t *out, uint64_t *nonzero_out, const Polynomial *p, const KZGSettings *s) {
+    return g1_lincomb_sparse(out, nonzero_out, s->g1_values, (const fr_t *)(&p->evals), blob_width(s), s);
 }
 
 /**
@@ -966,16 +1593,41 @@ static C_KZG_RET poly_to_kzg_commitment(g1_t *out, const Polynomial *p, const KZ
  * @retval C_KZG_BADARGS Invalid input blob
  */
 C_KZG_RET blob_to_kzg_commitment(KZGCommitment *out, const Blob *blob, const KZGSettings *s) {
+    return blob_to_kzg_commitment_with_sparsity(out, NULL, blob, s);
+}
+
+/**
+ * Convert a blob to a KZG commitment, and report how many of its field elements were non-zero.
+ *
+ * Zero field elements, such as the padding after a partially filled blob, are skipped by the commitment MSM, so the
+ * count shows how much of the blob was actually committed to.
+ *
+ * @param[out] out         The resulting commitment
+ * @param[out] nonzero_out The number of non-zero field elements in the blob, may be NULL
+ * @param[in]  blob        The blob representing the polynomial to be committed to
+ * @param[in]  s           The settings struct containing the commitment key (i.e. the trusted setup)
+ * @retval C_KZG_OK      Commitment successful
+ * @retval C_KZG_BADARGS Invalid input blob
+ */
+C_KZG_RET blob_to_kzg_commitment_with_sparsity(KZGCommitment *out, uint64_t *nonzero_out, const Blob *blob,
+                                               const KZGSettings *s) {
     C_KZG_RET ret;
-    Polynomial p;
+    Polynomial *p = NULL;
     g1_t commitment;
 
-    ret = blob_to_polynomial(&p, blob);
-    if (ret != C_KZG_OK) return ret;
-    ret = poly_to_kzg_commitment(&commitment, &p, s);
-    if (ret != C_KZG_OK) return ret;
+    s = local_settings(s);
+
+    ret = new_polynomial(&p);
+    if (ret != C_KZG_OK) goto out;
+    ret = blob_to_polynomial(p, blob, s);
+    if (ret != C_KZG_OK) goto out;
+    ret = poly_to_kzg_commitment(&commitment, nonzero_out, p, s);
+    if (ret != C_KZG_OK) goto out;
     bytes_from_g1(out, &commitment);
-    return C_KZG_OK;
+
+out:
+    c_kzg_free(p);
+    return ret;
 }
 
 /* Forward function declaration */
@@ -1004,6 +1656,8 @@ C_KZG_RET verify_kzg_proof(bool *out,
     fr_t z_fr, y_fr;
     g1_t commitment_g1, proof_g1;
 
+    s = local_settings(s);
+
     ret = bytes_to_kzg_commitment(&commitment_g1, commitment_bytes);
     if (ret != C_KZG_OK) return ret;
     ret = bytes_to_bls_field(&z_fr, z_bytes);
@@ -1058,17 +1712,22 @@ C_KZG_RET compute_kzg_proof_impl(KZGProof *out, const Polynomial *polynomial, co
  */
 C_KZG_RET compute_kzg_proof(KZGProof *out, const Blob *blob, const Bytes32 *z_bytes, const KZGSettings *s) {
     C_KZG_RET ret;
-    Polynomial polynomial;
+    Polynomial *polynomial = NULL;
     fr_t frz;
 
-    ret = blob_to_polynomial(&polynomial, blob);
+    s = local_settings(s);
+
+    ret = new_polynomial(&polynomial);
+    if (ret != C_KZG_OK) goto out;
+    ret = blob_to_polynomial(polynomial, blob, s);
     if (ret != C_KZG_OK) goto out;
     ret = bytes_to_bls_field(&frz, z_bytes);
     if (ret != C_KZG_OK) goto out;
-    ret = compute_kzg_proof_impl(out, &polynomial, &frz, s);
+    ret = compute_kzg_proof_impl(out, polynomial, &frz, s);
     if (ret != C_KZG_OK) goto out;
 
 out:
+    c_kzg_free(polynomial);
     return ret;
 }
 
@@ -1085,6 +1744,7 @@ out:
 C_KZG_RET compute_kzg_proof_impl(KZGProof *out, const Polynomial *polynomial, const fr_t *z, const KZGSettings *s) {
     C_KZG_RET ret;
     fr_t y;
+    Polynomial *q = NULL;
     fr_t *inverses_in = NULL;
     fr_t *inverses = NULL;
 
@@ -1092,16 +1752,18 @@ C_KZG_RET compute_kzg_proof_impl(KZGProof *out, const Polynomial *polynomial, co
     if (ret != C_KZG_OK) goto out;
 
     fr_t tmp;
-    Polynomial q;
     const fr_t *roots_of_unity = s->fs->roots_of_unity;
+    uint64_t width = blob_width(s);
     uint64_t i, m = 0;
 
-    ret = new_fr_array(&inverses_in, FIELD_ELEMENTS_PER_BLOB);
+    ret = new_polynomial(&q);
     if (ret != C_KZG_OK) goto out;
-    ret = new_fr_array(&inverses, FIELD_ELEMENTS_PER_BLOB);
+    ret = new_fr_array(&inverses_in, width);
+    if (ret != C_KZG_OK) goto out;
+    ret = new_fr_array(&inverses, width);
     if (ret != C_KZG_OK) goto out;
 
-    for (i = 0; i < FIELD_ELEMENTS_PER_BLOB; i++) {
+    for (i = 0; i < width; i++) {
         if (fr_equal(z, &roots_of_unity[i])) {
             /* We are asked to compute a KZG proof inside the domain */
             m = i + 1;
@@ -1109,49 +1771,201 @@ C_KZG_RET compute_kzg_proof_impl(KZGProof *out, const Polynomial *polynomial, co
             continue;
         }
         // (p_i - y) / (ω_i - z)
-        blst_fr_sub(&q.evals[i], &polynomial->evals[i], &y);
+        blst_fr_sub(&q->evals[i], &polynomial->evals[i], &y);
         blst_fr_sub(&inverses_in[i], &roots_of_unity[i], z);
     }
 
-    ret = fr_batch_inv(inverses, inverses_in, FIELD_ELEMENTS_PER_BLOB);
+    ret = fr_batch_inv(inverses, inverses_in, width);
     if (ret != C_KZG_OK) goto out;
 
-    for (i = 0; i < FIELD_ELEMENTS_PER_BLOB; i++) {
-        blst_fr_mul(&q.evals[i], &q.evals[i], &inverses[i]);
+    for (i = 0; i < width; i++) {
+        blst_fr_mul(&q->evals[i], &q->evals[i], &inverses[i]);
     }
 
     if (m) { // ω_m == z
-        q.evals[--m] = FR_ZERO;
-        for (i = 0; i < FIELD_ELEMENTS_PER_BLOB; i++) {
+        q->evals[--m] = FR_ZERO;
+        for (i = 0; i < width; i++) {
             if (i == m) continue;
             /* Build denominator: z * (z - ω_i) */
             blst_fr_sub(&tmp, z, &roots_of_unity[i]);
             blst_fr_mul(&inverses_in[i], &tmp, z);
         }
 
-        ret = fr_batch_inv(inverses, inverses_in, FIELD_ELEMENTS_PER_BLOB);
+        ret = fr_batch_inv(inverses, inverses_in, width);
         if (ret != C_KZG_OK) goto out;
 
-        for (i = 0; i < FIELD_ELEMENTS_PER_BLOB; i++) {
+        for (i = 0; i < width; i++) {
             if (i == m) continue;
             /* Build numerator: ω_i * (p_i - y) */
             blst_fr_sub(&tmp, &polynomial->evals[i], &y);
             blst_fr_mul(&tmp, &tmp, &roots_of_unity[i]);
             /* Do the division: (p_i - y) * ω_i / (z * (z - ω_i)) */
             blst_fr_mul(&tmp, &tmp, &inverses[i]);
-            blst_fr_add(&q.evals[m], &q.evals[m], &tmp);
+            blst_fr_add(&q->evals[m], &q->evals[m], &tmp);
         }
     }
 
     g1_t out_g1;
-    ret = g1_lincomb(&out_g1, s->g1_values, (const fr_t *)(&q.evals), FIELD_ELEMENTS_PER_BLOB);
+    ret = g1_lincomb_sparse(&out_g1, NULL, s->g1_values, (const fr_t *)(&q->evals), width, s);
     if (ret != C_KZG_OK) goto out;
 
     bytes_from_g1(out, &out_g1);
 
 out:
-    free(inverses_in);
-    free(inverses);
+    c_kzg_free(q);
+    c_kzg_free(inverses_in);
+    c_kzg_free(inverses);
+    return ret;
+}
+
+/**
+ * The shared inputs of the per-point tasks of #compute_kzg_proofs_multi.
+ */
+typedef struct {
+    KZGProof *proofs;             /**< The proof for each point */
+    Bytes32 *ys;                  /**< The evaluation at each point */
+    C_KZG_RET *rets;              /**< The result for each point */
+    const Polynomial *polynomial; /**< The blob */
+    const fr_t *zs;               /**< The points */
+    const fr_t *weights;          /**< The barycentric weights of the blob */
+    const fr_t *inverses;         /**< The inverted differences from each point to the domain, a row per point */
+    const uint64_t *domain_index; /**< One more than the domain index of each point, or 0 if it is outside */
+    const KZGSettings *s;         /**< The settings */
+} MultiProofTask;
+
+/**
+ * Compute the proof and evaluation for one point of #compute_kzg_proofs_multi.
+ *
+ * @param[in,out] arg The #MultiProofTask
+ * @param[in]     j   The point
+ */
+static void multi_proof_at(void *arg, size_t j) {
+    MultiProofTask *t = arg;
+    const Polynomial *polynomial = t->polynomial;
+    const KZGSettings *s = t->s;
+    uint64_t i, width = blob_width(s);
+    C_KZG_RET ret;
+    Polynomial *q = NULL;
+    fr_t y;
+
+    if (t->domain_index[j]) {
+        /* z_j == ω_i, which needs the special-case quotient */
+        y = polynomial->evals[t->domain_index[j] - 1];
+        ret = compute_kzg_proof_impl(&t->proofs[j], polynomial, &t->zs[j], s);
+        if (ret != C_KZG_OK) goto out;
+    } else {
+        const fr_t *row = &t->inverses[j * width];
+        g1_t out_g1;
+
+        ret = new_polynomial(&q);
+        if (ret != C_KZG_OK) goto out;
+
+        evaluate_barycentric_weights(&y, t->weights, &t->zs[j], row, width);
+
+        // (p_i - y) / (ω_i - z) == (y - p_i) / (z - ω_i)
+        for (i = 0; i < width; i++) {
+            blst_fr_sub(&q->evals[i], &y, &polynomial->evals[i]);
+            blst_fr_mul(&q->evals[i], &q->evals[i], &row[i]);
+        }
+
+        ret = g1_lincomb_sparse(&out_g1, NULL, s->g1_values, (const fr_t *)(&q->evals), width, s);
+        if (ret != C_KZG_OK) goto out;
+        bytes_from_g1(&t->proofs[j], &out_g1);
+    }
+    bytes_from_bls_field(&t->ys[j], &y);
+
+out:
+    c_kzg_free(q);
+    t->rets[j] = ret;
+}
+
+/**
+ * Compute KZG proofs for a single blob at multiple evaluation points.
+ *
+ * The blob is deserialized once and its barycentric weights are shared across all points. The denominators `z_j - ω_i`
+ * for every point are inverted together in a single batch inversion, which leaves the quotient MSM as the main
+ * per-point cost. Points that fall inside the domain are rare and are handed to #compute_kzg_proof_impl individually.
+ * The points are proved in parallel on the settings' executor, if there is one.
+ *
+ * @param[out] out_proofs Array of @p k proofs, one per evaluation point
+ * @param[out] out_ys     Array of @p k evaluation results, the polynomial evaluated at each point
+ * @param[in]  blob       The blob (polynomial) to generate proofs for
+ * @param[in]  zs_bytes   Array of @p k evaluation points
+ * @param[in]  k          The number of evaluation points
+ * @param[in]  s          The settings containing the secrets, previously initialised with #new_kzg_settings
+ * @retval C_KZG_OK      All is well
+ * @retval C_KZG_BADARGS Invalid input blob or evaluation point
+ * @retval C_KZG_MALLOC  Memory allocation failed
+ */
+C_KZG_RET compute_kzg_proofs_multi(KZGProof *out_proofs,
+                                   Bytes32 *out_ys,
+                                   const Blob *blob,
+                                   const Bytes32 *zs_bytes,
+                                   size_t k,
+                                   const KZGSettings *s) {
+    C_KZG_RET ret;
+    Polynomial *polynomial = NULL;
+    fr_t *zs = NULL;
+    fr_t *weights = NULL;
+    fr_t *inverses = NULL;
+    uint64_t *domain_index = NULL;
+    C_KZG_RET *rets = NULL;
+    uint64_t width, j;
+    MultiProofTask task;
+
+    s = local_settings(s);
+    width = blob_width(s);
+
+    ret = new_polynomial(&polynomial);
+    if (ret != C_KZG_OK) goto out;
+    ret = blob_to_polynomial(polynomial, blob, s);
+    if (ret != C_KZG_OK) goto out;
+    if (k == 0) goto out;
+
+    ret = new_fr_array(&zs, k);
+    if (ret != C_KZG_OK) goto out;
+    ret = new_fr_array(&weights, width);
+    if (ret != C_KZG_OK) goto out;
+    ret = new_fr_array(&inverses, k * width);
+    if (ret != C_KZG_OK) goto out;
+    ret = c_kzg_malloc((void **)&domain_index, k * sizeof *domain_index);
+    if (ret != C_KZG_OK) goto out;
+    ret = c_kzg_malloc((void **)&rets, k * sizeof *rets);
+    if (ret != C_KZG_OK) goto out;
+
+    for (j = 0; j < k; j++) {
+        ret = bytes_to_bls_field(&zs[j], &zs_bytes[j]);
+        if (ret != C_KZG_OK) goto out;
+    }
+
+    ret = batch_inverse_differences(inverses, domain_index, zs, k, s);
+    if (ret != C_KZG_OK) goto out;
+
+    compute_barycentric_weights(weights, polynomial, s);
+
+    task.proofs = out_proofs;
+    task.ys = out_ys;
+    task.rets = rets;
+    task.polynomial = polynomial;
+    task.zs = zs;
+    task.weights = weights;
+    task.inverses = inverses;
+    task.domain_index = domain_index;
+    task.s = s;
+    run_parallel(s, multi_proof_at, &task, k);
+
+    for (j = 0; j < k; j++) {
+        ret = rets[j];
+        if (ret != C_KZG_OK) goto out;
+    }
+
+out:
+    c_kzg_free(polynomial);
+    c_kzg_free(zs);
+    c_kzg_free(weights);
+    c_kzg_free(inverses);
+    c_kzg_free(domain_index);
+    c_kzg_free(rets);
     return ret;
 }
 
@@ -1169,27 +1983,92 @@ out:
  * @param[in]  polys           Array of polynomials
  * @param[in]  kzg_commitments Array of KZG commitments
  * @param[in]  n               Number of polynomials and commitments
+ * @param[in]  width           The number of evaluations in each polynomial
  * @retval C_KZG_OK     Operation successful
  * @retval C_KZG_MALLOC Memory allocation failed
  */
 static C_KZG_RET compute_aggregated_poly_and_commitment(Polynomial *poly_out, g1_t *comm_out, fr_t *chal_out,
         const Polynomial *polys,
         const g1_t *kzg_commitments,
-        size_t n) {
-    fr_t* r_powers = calloc(n, sizeof(fr_t));
-    if (n > 0 && r_powers == NULL) return C_KZG_MALLOC;
+        size_t n,
+        uint64_t width) {
+    fr_t *r_powers = NULL;
+    C_KZG_RET ret = c_kzg_calloc((void **)&r_powers, n, sizeof(fr_t));
+    if (ret != C_KZG_OK) return ret;
 
-    C_KZG_RET ret;
-    ret = compute_challenges(chal_out, r_powers, polys, kzg_commitments, n);
+    ret = compute_challenges(chal_out, r_powers, polys, kzg_commitments, n, width);
     if (ret != C_KZG_OK) goto out;
 
-    poly_lincomb(poly_out, polys, r_powers, n);
+    poly_lincomb(poly_out, polys, r_powers, n, width);
 
     ret = g1_lincomb(comm_out, kzg_commitments, r_powers, n);
     if (ret != C_KZG_OK) goto out;
 
 out:
-    free(r_powers);
+    c_kzg_free(r_powers);
+    return ret;
+}
+
+/**
+ * The shared inputs of the per-blob tasks of the aggregate functions.
+ */
+typedef struct {
+    Polynomial *polys;    /**< The polynomial of each blob */
+    g1_t *commitments;    /**< The commitment to each blob, or NULL to skip committing */
+    C_KZG_RET *rets;      /**< The result for each blob */
+    const Blob *blobs;    /**< The blobs */
+    const KZGSettings *s; /**< The settings */
+} BlobTask;
+
+/**
+ * Deserialize one blob of an aggregate, and commit to it if asked to.
+ *
+ * @param[in,out] arg The #BlobTask
+ * @param[in]     i   The blob
+ */
+static void blob_task_at(void *arg, size_t i) {
+    BlobTask *t = arg;
+    C_KZG_RET ret;
+
+    ret = blob_to_polynomial(&t->polys[i], blob_at(t->blobs, i, t->s), t->s);
+    if (ret == C_KZG_OK && t->commitments != NULL) {
+        ret = poly_to_kzg_commitment(&t->commitments[i], NULL, &t->polys[i], t->s);
+    }
+    t->rets[i] = ret;
+}
+
+/**
+ * Deserialize the blobs of an aggregate on the settings' executor, and commit to them if asked to.
+ *
+ * @param[out] polys       The polynomial of each blob
+ * @param[out] commitments The commitment to each blob, or NULL to skip committing
+ * @param[in]  blobs       The blobs, packed at the preset blob size of @p s
+ * @param[in]  n           The number of blobs
+ * @param[in]  s           The settings
+ * @retval C_KZG_OK      All is well
+ * @retval C_KZG_BADARGS Invalid input blob bytes
+ * @retval C_KZG_MALLOC  Memory allocation failed
+ */
+static C_KZG_RET blobs_to_polynomials(Polynomial *polys, g1_t *commitments, const Blob *blobs, size_t n,
+                                      const KZGSettings *s) {
+    C_KZG_RET ret;
+    BlobTask task;
+
+    if (n == 0) return C_KZG_OK;
+    ret = c_kzg_malloc((void **)&task.rets, n * sizeof(C_KZG_RET));
+    if (ret != C_KZG_OK) return ret;
+
+    task.polys = polys;
+    task.commitments = commitments;
+    task.blobs = blobs;
+    task.s = s;
+    run_parallel(s, blob_task_at, &task, n);
+
+    for (size_t i = 0; i < n; i++) {
+        ret = task.rets[i];
+        if (ret != C_KZG_OK) break;
+    }
+    c_kzg_free(task.rets);
     return ret;
 }
 
@@ -1199,7 +2078,7 @@ out:
  * @remark This function should work even if `n==0`.
  *
  * @param[out] out   The output aggregate KZG proof.
- * @param[in]  blobs Array of Blob objects to compute the aggregate proof for.
+ * @param[in]  blobs Array of blobs to compute the aggregate proof for, packed at the preset blob size of @p s
  * @param[in]  n     The number of blobs in the array.
  * @param[in]  s     The settings struct containing the commitment key (i.e. the trusted setup)
  * @retval C_KZG_OK      Operation successful
@@ -1213,36 +2092,32 @@ C_KZG_RET compute_aggregate_kzg_proof(KZGProof *out,
     C_KZG_RET ret = C_KZG_MALLOC;
     Polynomial* polys = NULL;
     g1_t* commitments = NULL;
+    Polynomial *aggregated_poly = NULL;
 
-    commitments = calloc(n, sizeof(g1_t));
-    if (n > 0 && commitments == NULL) {
-        goto out;
-    }
+    s = local_settings(s);
 
-    polys = calloc(n, sizeof(Polynomial));
-    if (n > 0 && polys == NULL) {
-        goto out;
-    }
+    ret = c_kzg_calloc((void **)&commitments, n, sizeof(g1_t));
+    if (ret != C_KZG_OK) goto out;
+    ret = c_kzg_calloc((void **)&polys, n, sizeof(Polynomial));
+    if (ret != C_KZG_OK) goto out;
 
-    for (size_t i = 0; i < n; i++) {
-        ret = blob_to_polynomial(&polys[i], &blobs[i]);
-        if (ret != C_KZG_OK) goto out;
-        ret = poly_to_kzg_commitment(&commitments[i], &polys[i], s);
-        if (ret != C_KZG_OK) goto out;
-    }
+    ret = blobs_to_polynomials(polys, commitments, blobs, n, s);
+    if (ret != C_KZG_OK) goto out;
 
-    Polynomial aggregated_poly;
     g1_t aggregated_poly_commitment;
     fr_t evaluation_challenge;
-    ret = compute_aggregated_poly_and_commitment(&aggregated_poly, &aggregated_poly_commitment, &evaluation_challenge, polys, commitments, n);
+    ret = new_polynomial(&aggregated_poly);
+    if (ret != C_KZG_OK) goto out;
+    ret = compute_aggregated_poly_and_commitment(aggregated_poly, &aggregated_poly_commitment, &evaluation_challenge, polys, commitments, n, blob_width(s));
     if (ret != C_KZG_OK) goto out;
 
-    ret = compute_kzg_proof_impl(out, &aggregated_poly, &evaluation_challenge, s);
+    ret = compute_kzg_proof_impl(out, aggregated_poly, &evaluation_challenge, s);
     if (ret != C_KZG_OK) goto out;
 
 out:
-    free(commitments);
-    free(polys);
+    c_kzg_free(commitments);
+    c_kzg_free(polys);
+    c_kzg_free(aggregated_poly);
     return ret;
 }
 
@@ -1250,7 +2125,7 @@ out:
  * Computes the aggregate KZG proof for multiple blobs.
  *
  * @param[out] out   `true` if the proof is valid, `false` if not
- * @param[in]  blobs Array of Blob objects to compute the aggregate proof for.
+ * @param[in]  blobs Array of blobs to compute the aggregate proof for, packed at the preset blob size of @p s
  * @param[in]  n     The number of blobs in the array.
  * @param[in]  s     The settings struct containing the commitment verification key (i.e. the trusted setup)
  * @retval C_KZG_OK      Operation successful
@@ -1266,43 +2141,43 @@ C_KZG_RET verify_aggregate_kzg_proof(bool *out,
     C_KZG_RET ret = C_KZG_MALLOC;
     g1_t* commitments = NULL;
     Polynomial* polys = NULL;
+    Polynomial *aggregated_poly = NULL;
+
+    s = local_settings(s);
 
     g1_t proof;
     ret = bytes_to_kzg_proof(&proof, aggregated_proof_bytes);
     if (ret != C_KZG_OK) goto out;
 
-    commitments = calloc(n, sizeof(g1_t));
-    if (n > 0 && commitments == NULL) {
-        goto out;
-    }
-
-    polys = calloc(n, sizeof(Polynomial));
-    if (n > 0 && polys == NULL) {
-        goto out;
-    }
+    ret = c_kzg_calloc((void **)&commitments, n, sizeof(g1_t));
+    if (ret != C_KZG_OK) goto out;
+    ret = c_kzg_calloc((void **)&polys, n, sizeof(Polynomial));
+    if (ret != C_KZG_OK) goto out;
 
     for (size_t i = 0; i < n; i++) {
         ret = bytes_to_kzg_commitment(&commitments[i], &commitments_bytes[i]);
         if (ret != C_KZG_OK) goto out;
-        ret = blob_to_polynomial(&polys[i], &blobs[i]);
-        if (ret != C_KZG_OK) goto out;
     }
+    ret = blobs_to_polynomials(polys, NULL, blobs, n, s);
+    if (ret != C_KZG_OK) goto out;
 
-    Polynomial aggregated_poly;
     g1_t aggregated_poly_commitment;
     fr_t evaluation_challenge;
-    ret = compute_aggregated_poly_and_commitment(&aggregated_poly, &aggregated_poly_commitment, &evaluation_challenge, polys, commitments, n);
+    ret = new_polynomial(&aggregated_poly);
+    if (ret != C_KZG_OK) goto out;
+    ret = compute_aggregated_poly_and_commitment(aggregated_poly, &aggregated_poly_commitment, &evaluation_challenge, polys, commitments, n, blob_width(s));
     if (ret != C_KZG_OK) goto out;
 
     fr_t y;
-    ret = evaluate_polynomial_in_evaluation_form(&y, &aggregated_poly, &evaluation_challenge, s);
+    ret = evaluate_polynomial_in_evaluation_form(&y, aggregated_poly, &evaluation_challenge, s);
     if (ret != C_KZG_OK) goto out;
 
     ret = verify_kzg_proof_impl(out, &aggregated_poly_commitment, &evaluation_challenge, &y, &proof, s);
 
 out:
-    free(commitments);
-    free(polys);
+    c_kzg_free(commitments);
+    c_kzg_free(polys);
+    c_kzg_free(aggregated_poly);
     return ret;
 }
 
@@ -1327,19 +2202,19 @@ out:
  * @param[out] out          The results (array of length @p n)
  * @param[in]  in           The input data (array of length @p n * @p stride)
  * @param[in]  stride       The input data stride
- * @param[in]  roots        Roots of unity (array of length @p n * @p roots_stride)
+ * @param[in]  fs           The FFT settings containing the roots of unity
  * @param[in]  roots_stride The stride interval among the roots of unity
  * @param[in]  n            Length of the FFT, must be a power of two
  */
-static void fft_g1_fast(g1_t *out, const g1_t *in, uint64_t stride, const fr_t *roots, uint64_t roots_stride,
+static void fft_g1_fast(g1_t *out, const g1_t *in, uint64_t stride, const FFTSettings *fs, uint64_t roots_stride,
                         uint64_t n) {
     uint64_t half = n / 2;
     if (half > 0) { // Tunable parameter
-        fft_g1_fast(out, in, stride * 2, roots, roots_stride * 2, half);
-        fft_g1_fast(out + half, in + stride, stride * 2, roots, roots_stride * 2, half);
+        fft_g1_fast(out, in, stride * 2, fs, roots_stride * 2, half);
+        fft_g1_fast(out + half, in + stride, stride * 2, fs, roots_stride * 2, half);
         for (uint64_t i = 0; i < half; i++) {
             g1_t y_times_root;
-            g1_mul(&y_times_root, &out[i + half], &roots[i * roots_stride]);
+            g1_mul(&y_times_root, &out[i + half], expanded_root_of_unity(fs, i * roots_stride));
             g1_sub(&out[i + half], &out[i], &y_times_root);
             blst_p1_add_or_double(&out[i], &out[i], &y_times_root);
         }
@@ -1351,6 +2226,9 @@ static void fft_g1_fast(g1_t *out, const g1_t *in, uint64_t stride, const fr_t *
 /**
  * The main entry point for forward and reverse FFTs over the finite field.
  *
+ * The inverse transform is the forward transform with the outputs after the first in reverse order, scaled by `1/n`.
+ * This saves keeping a descending copy of the roots of unity.
+ *
  * @param[out] out     The results (array of length @p n)
  * @param[in]  in      The input data (array of length @p n)
  * @param[in]  inverse `false` for forward transform, `true` for inverse transform
@@ -1360,19 +2238,24 @@ static void fft_g1_fast(g1_t *out, const g1_t *in, uint64_t stride, const fr_t *
  * @retval C_CZK_BADARGS Invalid parameters were supplied
  */
 static C_KZG_RET fft_g1(g1_t *out, const g1_t *in, bool inverse, uint64_t n, const FFTSettings *fs) {
-    uint64_t stride = fs->max_width / n;
-    CHECK(n <= fs->max_width);
+    uint64_t stride;
+    CHECK(n > 0 && n <= fs->max_width);
     CHECK(is_power_of_two(n));
+    stride = fs->max_width / n;
+    fft_g1_fast(out, in, 1, fs, stride, n);
     if (inverse) {
         fr_t inv_len;
+        g1_t tmp;
         fr_from_uint64(&inv_len, n);
         blst_fr_eucl_inverse(&inv_len, &inv_len);
-        fft_g1_fast(out, in, 1, fs->reverse_roots_of_unity, stride, n);
+        for (uint64_t i = 1; i < n - i; i++) {
+            tmp = out[i];
+            out[i] = out[n - i];
+            out[n - i] = tmp;
+        }
         for (uint64_t i = 0; i < n; i++) {
             g1_mul(&out[i], &out[i], &inv_len);
         }
-    } else {
-        fft_g1_fast(out, in, 1, fs->expanded_roots_of_unity, stride, n);
     }
     return C_KZG_OK;
 }
@@ -1405,14 +2288,17 @@ static C_KZG_RET expand_root_of_unity(fr_t *out, const fr_t *root, uint64_t widt
 /**
  * Initialise an FFTSettings structure.
  *
- * Space is allocated for, and arrays are populated with, powers of the roots of unity. The two arrays contain the same
- * values in reverse order for convenience in inverse FFTs.
+ * Space is allocated for, and arrays are populated with, powers of the roots of unity. Only the bit-reversal permuted
+ * order that the polynomial functions use is stored; the FFTs read the ascending powers through
+ * #expanded_root_of_unity.
  *
  * `max_width` is the maximum size of FFT that can be calculated with these settings, and is a power of two by
  * construction. The same settings may be used to calculated FFTs of smaller power sizes.
  *
  * @remark As with all functions prefixed `new_`, this allocates memory that needs to be reclaimed by calling the
  * corresponding `free_` function. In this case, #free_fft_settings.
+ * @remark When built with `STATIC_ROOTS_OF_UNITY` and @p max_scale matches the generated tables, nothing is allocated
+ * and the settings point into read-only data instead.
  * @remark These settings may be used for FFTs on both field elements and G1 group elements.
  *
  * @param[out] fs        The new settings
@@ -1425,56 +2311,90 @@ static C_KZG_RET expand_root_of_unity(fr_t *out, const fr_t *root, uint64_t widt
 static C_KZG_RET new_fft_settings(FFTSettings *fs, unsigned int max_scale) {
     C_KZG_RET ret;
     fr_t root_of_unity;
+    fr_t *expanded_roots_of_unity = NULL;
+    fr_t *roots_of_unity = NULL;
+    fr_t *roots_of_unity_div_width = NULL;
 
     fs->max_width = (uint64_t)1 << max_scale;
-    fs->expanded_roots_of_unity = NULL;
-    fs->reverse_roots_of_unity = NULL;
     fs->roots_of_unity = NULL;
+    fs->roots_of_unity_div_width = NULL;
 
     CHECK((max_scale < sizeof SCALE2_ROOT_OF_UNITY / sizeof SCALE2_ROOT_OF_UNITY[0]));
+
+#ifdef STATIC_ROOTS_OF_UNITY
+    // Use the tables generated at build time when they are the right size
+    if (fs->max_width == ROOTS_OF_UNITY_WIDTH) {
+        fs->roots_of_unity = ROOTS_OF_UNITY;
+        fs->roots_of_unity_div_width = ROOTS_OF_UNITY_DIV_WIDTH;
+        return C_KZG_OK;
+    }
+#endif
+
     blst_fr_from_uint64(&root_of_unity, SCALE2_ROOT_OF_UNITY[max_scale]);
 
     // Allocate space for the roots of unity
-    ret = new_fr_array(&fs->expanded_roots_of_unity, fs->max_width + 1);
+    ret = new_fr_array(&expanded_roots_of_unity, fs->max_width + 1);
     if (ret != C_KZG_OK) goto out_error;
-    ret = new_fr_array(&fs->reverse_roots_of_unity, fs->max_width + 1);
+    ret = new_fr_array(&roots_of_unity, fs->max_width);
     if (ret != C_KZG_OK) goto out_error;
-    ret = new_fr_array(&fs->roots_of_unity, fs->max_width);
+    ret = new_fr_array(&roots_of_unity_div_width, fs->max_width);
     if (ret != C_KZG_OK) goto out_error;
 
-    // Populate the roots of unity
-    ret = expand_root_of_unity(fs->expanded_roots_of_unity, &root_of_unity, fs->max_width);
+    // Populate the roots of unity, which also checks that the root has the right order
+    ret = expand_root_of_unity(expanded_roots_of_unity, &root_of_unity, fs->max_width);
     if (ret != C_KZG_OK) goto out_error;
 
-    // Populate reverse roots of unity
-    for (uint64_t i = 0; i <= fs->max_width; i++) {
-        fs->reverse_roots_of_unity[i] = fs->expanded_roots_of_unity[fs->max_width - i];
-    }
-
     // Permute the roots of unity
-    memcpy(fs->roots_of_unity, fs->expanded_roots_of_unity, sizeof(fr_t) * fs->max_width);
-    ret = bit_reversal_permutation(fs->roots_of_unity, sizeof(fr_t), fs->max_width);
+    memcpy(roots_of_unity, expanded_roots_of_unity, sizeof(fr_t) * fs->max_width);
+    ret = bit_reversal_permutation(roots_of_unity, sizeof(fr_t), fs->max_width);
     if (ret != C_KZG_OK) goto out_error;
 
+    // Divide the permuted roots of unity by the width, for barycentric evaluation
+    fr_t inv_width;
+    fr_from_uint64(&inv_width, fs->max_width);
+    blst_fr_eucl_inverse(&inv_width, &inv_width);
+    for (uint64_t i = 0; i < fs->max_width; i++) {
+        blst_fr_mul(&roots_of_unity_div_width[i], &roots_of_unity[i], &inv_width);
+    }
+
+    fs->roots_of_unity = roots_of_unity;
+    fs->roots_of_unity_div_width = roots_of_unity_div_width;
+    ret = C_KZG_OK;
     goto out_success;
 
 out_error:
-    free(fs->expanded_roots_of_unity);
-    free(fs->reverse_roots_of_unity);
-    free(fs->roots_of_unity);
+    c_kzg_free(roots_of_unity);
+    c_kzg_free(roots_of_unity_div_width);
 out_success:
+    c_kzg_free(expanded_roots_of_unity);
     return ret;
 }
 
+/**
+ * Test whether an FFTSettings structure points into the tables generated at build time.
+ *
+ * @param[in] fs The settings to check
+ * @retval true  The roots of unity are static, read-only data
+ * @retval false The roots of unity were allocated by #new_fft_settings
+ */
+static bool fft_settings_are_static(const FFTSettings *fs) {
+#ifdef STATIC_ROOTS_OF_UNITY
+    return fs->roots_of_unity == ROOTS_OF_UNITY;
+#else
+    return false;
+#endif
+}
+
 /**
  * Free the memory that was previously allocated by #new_fft_settings.
  *
  * @param fs The settings to be freed
  */
 static void free_fft_settings(FFTSettings *fs) {
-    free(fs->expanded_roots_of_unity);
-    free(fs->reverse_roots_of_unity);
-    free(fs->roots_of_unity);
+    if (!fft_settings_are_static(fs)) {
+        c_kzg_free((void *)fs->roots_of_unity);
+        c_kzg_free((void *)fs->roots_of_unity_div_width);
+    }
     fs->max_width = 0;
 }
 
@@ -1484,21 +2404,61 @@ static void free_fft_settings(FFTSettings *fs) {
  * @param ks The settings to be freed
  */
 static void free_kzg_settings(KZGSettings *ks) {
-    free((FFTSettings*)ks->fs);
-    free(ks->g1_values);
-    free(ks->g2_values);
+    c_kzg_free((FFTSettings*)ks->fs);
+    c_kzg_free((void *)ks->g1_values);
+    c_kzg_free((void *)ks->g2_values);
+}
+
+/**
+ * Report the memory used by a KZGSettings.
+ *
+ * Counts the heap allocations made by #load_trusted_setup. Roots of unity tables generated at build time are shared
+ * read-only data, and are not counted. Neither are the mappings made by #attach_trusted_setup and
+ * #place_trusted_setup, which are not heap memory and, when attached, are shared with other processes.
+ *
+ * @param[in] s The settings, previously initialised with #load_trusted_setup or #attach_trusted_setup
+ * @return The number of bytes allocated for @p s
+ */
+size_t kzg_settings_memory_usage(const KZGSettings *s) {
+    size_t width = s->fs->max_width;
+    size_t total = sizeof(FFTSettings);
+    if (s->image != NULL) return total;
+    if (!fft_settings_are_static(s->fs)) {
+        total += 2 * width * sizeof(fr_t);
+    }
+    total += width * sizeof(blst_p1_affine);
+    total += NUM_G2_VALUES * sizeof(g2_t);
+    return total;
+}
+
+/**
+ * Report the blob size of the preset that some settings were loaded for.
+ *
+ * A library build supports every preset up to `FIELD_ELEMENTS_PER_BLOB` field elements per blob, and the trusted
+ * setup that is loaded picks one. Blobs passed with these settings must have this many field elements, and arrays of
+ * blobs are packed at this size rather than at `sizeof(Blob)`.
+ *
+ * @param[in] s The settings
+ * @return The number of field elements per blob
+ */
+uint64_t kzg_settings_field_elements_per_blob(const KZGSettings *s) {
+    return blob_width(s);
 }
 
 /**
  * Load trusted setup into a KZGSettings.
  *
+ * Only what the KZG functions use is kept: the G1 points in Lagrange form, stored affine since that is what Pippenger
+ * consumes, and the first two G2 points, `[1]` and `[s]`.
+ *
  * @remark Free after use with #free_trusted_setup.
  *
  * @param[out] out Pointer to the stored trusted setup data
  * @param g1_bytes Array of G1 elements
- * @param n1       Length of `g1`
+ * @param n1       Length of `g1`, the number of field elements per blob: a power of two from two
+ *                 to `FIELD_ELEMENTS_PER_BLOB`
  * @param g2_bytes Array of G2 elements
- * @param n2       Length of `g2`
+ * @param n2       Length of `g2`, at least two
  * @retval C_CZK_OK      All is well
  * @retval C_CZK_BADARGS Invalid parameters were supplied
  * @retval C_CZK_ERROR   An internal error occurred
@@ -1507,28 +2467,41 @@ static void free_kzg_settings(KZGSettings *ks) {
 C_KZG_RET load_trusted_setup(KZGSettings *out, const uint8_t *g1_bytes, size_t n1, const uint8_t *g2_bytes, size_t n2) {
     uint64_t i;
     blst_p2_affine g2_affine;
+    blst_p1_affine *g1_values = NULL;
+    g2_t *g2_values = NULL;
     g1_t *g1_projective = NULL;
+    g1_t *g1_lagrange = NULL;
     C_KZG_RET ret;
 
     out->fs = NULL;
     out->g1_values = NULL;
     out->g2_values = NULL;
+    out->image = NULL;
+    out->image_size = 0;
+    out->replicas = NULL;
+    out->num_replicas = 0;
+    out->executor = NULL;
+
+    CHECK(n1 >= 2 && n1 <= FIELD_ELEMENTS_PER_BLOB && is_power_of_two(n1));
+    CHECK(n2 >= NUM_G2_VALUES);
 
-    ret = new_g1_array(&out->g1_values, n1);
+    ret = c_kzg_malloc((void **)&g1_values, n1 * sizeof(blst_p1_affine));
     if (ret != C_KZG_OK) goto out_error;
-    ret = new_g2_array(&out->g2_values, n2);
+    ret = new_g2_array(&g2_values, NUM_G2_VALUES);
     if (ret != C_KZG_OK) goto out_error;
     ret = new_g1_array(&g1_projective, n1);
     if (ret != C_KZG_OK) goto out_error;
+    ret = new_g1_array(&g1_lagrange, n1);
+    if (ret != C_KZG_OK) goto out_error;
 
     for (i = 0; i < n1; i++) {
         ret = validate_kzg_g1(&g1_projective[i], (Bytes48 *)&g1_bytes[48 * i]);
         if (ret != C_KZG_OK) goto out_error;
     }
 
-    for (i = 0; i < n2; i++) {
+    for (i = 0; i < NUM_G2_VALUES; i++) {
         blst_p2_uncompress(&g2_affine, &g2_bytes[96 * i]);
-        blst_p2_from_affine(&out->g2_values[i], &g2_affine);
+        blst_p2_from_affine(&g2_values[i], &g2_affine);
     }
 
     unsigned int max_scale = 0;
@@ -1538,64 +2511,1160 @@ C_KZG_RET load_trusted_setup(KZGSettings *out, const uint8_t *g1_bytes, size_t n
     if (ret != C_KZG_OK) goto out_error;
     ret = new_fft_settings((FFTSettings*)out->fs, max_scale);
     if (ret != C_KZG_OK) goto out_error;
-    ret = fft_g1(out->g1_values, g1_projective, true, n1, out->fs);
+    ret = fft_g1(g1_lagrange, g1_projective, true, n1, out->fs);
     if (ret != C_KZG_OK) goto out_error;
-    ret = bit_reversal_permutation(out->g1_values, sizeof(g1_t), n1);
+
+    // Store the Lagrange form affine, in bit-reversal permutation
+    const blst_p1 *p_arg[2] = {g1_lagrange, NULL};
+    blst_p1s_to_affine(g1_values, p_arg, n1);
+    ret = bit_reversal_permutation(g1_values, sizeof(blst_p1_affine), n1);
     if (ret != C_KZG_OK) goto out_error;
 
+    out->g1_values = g1_values;
+    out->g2_values = g2_values;
     goto out_success;
 
 out_error:
-    free((void *)out->fs);
-    free(out->g1_values);
-    free(out->g2_values);
+    if (out->fs != NULL) free_fft_settings((FFTSettings *)out->fs);
+    c_kzg_free((void *)out->fs);
+    out->fs = NULL;
+    c_kzg_free(g1_values);
+    c_kzg_free(g2_values);
 out_success:
-    free(g1_projective);
+    c_kzg_free(g1_projective);
+    c_kzg_free(g1_lagrange);
     return ret;
 }
 
-/*
- * Load trusted setup from a file.
- *
- * @remark The file format is n1 n2 g1_1 g1_2 ... g1_n1 g2_1 ... g2_n2
- * @remark where the first two numbers are in decimal and the remainder
- * @remark are hexstrings and any whitespace can be used as separators.
- * @remark See also #load_trusted_setup.
- *
- * @param[out] out Pointer to the loaded trusted setup data
- * @param[in]  in  File handle for input - will not be closed
+/**
+ * The value of each hex digit plus one, so that zero marks characters that are not hex digits.
  */
-C_KZG_RET load_trusted_setup_file(KZGSettings *out, FILE *in) {
-    uint64_t i;
-    int num_matches;
-
-    num_matches = fscanf(in, "%" SCNu64, &i);
-    CHECK(num_matches == 1);
-    CHECK(i == FIELD_ELEMENTS_PER_BLOB);
-    num_matches = fscanf(in, "%" SCNu64, &i);
-    CHECK(num_matches == 1);
-    CHECK(i == 65);
+static const uint8_t HEX_DIGIT_VALUES[256] = {
+    ['0'] = 1,  ['1'] = 2,  ['2'] = 3,  ['3'] = 4,  ['4'] = 5,  ['5'] = 6,  ['6'] = 7,  ['7'] = 8,
+    ['8'] = 9,  ['9'] = 10, ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+};
 
-    uint8_t g1_bytes[FIELD_ELEMENTS_PER_BLOB * 48];
-    uint8_t g2_bytes[65 * 96];
+/**
+ * Advance past any whitespace.
+ *
+ * @param[in,out] p   The current position
+ * @param[in]     end The end of the text
+ */
+static void skip_whitespace(const char **p, const char *end) {
+    while (*p < end && isspace((unsigned char)**p)) (*p)++;
+}
 
-    for (i = 0; i < FIELD_ELEMENTS_PER_BLOB * 48; i++) {
-        num_matches = fscanf(in, "%2hhx", &g1_bytes[i]);
-        CHECK(num_matches == 1);
+/**
+ * Parse a decimal number, after any whitespace.
+ *
+ * @param[out]    out The number
+ * @param[in,out] p   The current position, advanced past the number
+ * @param[in]     end The end of the text
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS There is no number, or it does not fit in 64 bits
+ */
+static C_KZG_RET parse_decimal(uint64_t *out, const char **p, const char *end) {
+    uint64_t n = 0;
+
+    skip_whitespace(p, end);
+    CHECK(*p < end && isdigit((unsigned char)**p));
+    for (; *p < end && isdigit((unsigned char)**p); (*p)++) {
+        uint64_t digit = **p - '0';
+        CHECK(n <= (UINT64_MAX - digit) / 10);
+        n = n * 10 + digit;
     }
 
-    for (i = 0; i < 65 * 96; i++) {
-        num_matches = fscanf(in, "%2hhx", &g2_bytes[i]);
-        CHECK(num_matches == 1);
+    *out = n;
+    return C_KZG_OK;
+}
+
+/**
+ * Parse hex encoded bytes, each of which may be preceded by whitespace.
+ *
+ * @param[out]    out The bytes
+ * @param[in]     n   The number of bytes to parse
+ * @param[in,out] p   The current position, advanced past the bytes
+ * @param[in]     end The end of the text
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS The text ends early or has a character that is not a hex digit
+ */
+static C_KZG_RET parse_hex_bytes(uint8_t *out, size_t n, const char **p, const char *end) {
+    for (size_t i = 0; i < n; i++) {
+        skip_whitespace(p, end);
+        CHECK(end - *p >= 2);
+        uint8_t hi = HEX_DIGIT_VALUES[(uint8_t)(*p)[0]];
+        uint8_t lo = HEX_DIGIT_VALUES[(uint8_t)(*p)[1]];
+        CHECK(hi != 0 && lo != 0);
+        out[i] = (uint8_t)((hi - 1) << 4 | (lo - 1));
+        *p += 2;
     }
+    return C_KZG_OK;
+}
+
+/**
+ * Load trusted setup from text in memory.
+ *
+ * @remark The format is the same as for #load_trusted_setup_file. The text does not need to be NUL terminated.
+ * @remark See also #load_trusted_setup.
+ *
+ * @param[out] out Pointer to the loaded trusted setup data
+ * @param[in]  buf The text of a trusted setup file
+ * @param[in]  len The length of @p buf in bytes
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS The text is not a valid trusted setup
+ * @retval C_CZK_ERROR   An internal error occurred
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET load_trusted_setup_from_buffer(KZGSettings *out, const char *buf, size_t len) {
+    C_KZG_RET ret;
+    const char *p = buf;
+    const char *end = buf + len;
+    uint64_t n1, n2;
+    uint8_t *g1_bytes = NULL;
+    uint8_t *g2_bytes = NULL;
 
-    return load_trusted_setup(out, g1_bytes, FIELD_ELEMENTS_PER_BLOB, g2_bytes, 65);
+    ret = parse_decimal(&n1, &p, end);
+    if (ret != C_KZG_OK) return ret;
+    CHECK(n1 >= 2 && n1 <= FIELD_ELEMENTS_PER_BLOB);
+    ret = parse_decimal(&n2, &p, end);
+    if (ret != C_KZG_OK) return ret;
+    CHECK(n2 >= NUM_G2_VALUES);
+    /* Each point takes twice its size in hex digits, which also keeps the sizes below from overflowing */
+    CHECK(n1 <= len / (2 * 48) && n2 <= len / (2 * 96));
+
+    ret = c_kzg_malloc((void **)&g1_bytes, n1 * 48);
+    if (ret != C_KZG_OK) goto out;
+    ret = c_kzg_malloc((void **)&g2_bytes, n2 * 96);
+    if (ret != C_KZG_OK) goto out;
+
+    ret = parse_hex_bytes(g1_bytes, n1 * 48, &p, end);
+    if (ret != C_KZG_OK) goto out;
+    ret = parse_hex_bytes(g2_bytes, n2 * 96, &p, end);
+    if (ret != C_KZG_OK) goto out;
+
+    ret = load_trusted_setup(out, g1_bytes, n1, g2_bytes, n2);
+
+out:
+    c_kzg_free(g1_bytes);
+    c_kzg_free(g2_bytes);
+    return ret;
+}
+
+/*
+ * Load trusted setup from a file.
+ *
+ * @remark The file format is n1 n2 g1_1 g1_2 ... g1_n1 g2_1 ... g2_n2
+ * @remark where the first two numbers are in decimal and the remainder
+ * @remark are hexstrings and any whitespace can be used as separators.
+ * @remark See also #load_trusted_setup and #load_trusted_setup_from_buffer.
+ *
+ * @param[out] out Pointer to the loaded trusted setup data
+ * @param[in]  in  File handle for input - will not be closed
+ */
+C_KZG_RET load_trusted_setup_file(KZGSettings *out, FILE *in) {
+    C_KZG_RET ret;
+    char *buf = NULL;
+    size_t len = 0;
+    size_t capacity = (size_t)1 << 20;
+
+    // Read the whole file, which is under a megabyte for the mainnet setup
+    for (;;) {
+        char *grown;
+        ret = c_kzg_malloc((void **)&grown, capacity);
+        if (ret != C_KZG_OK) goto out;
+        if (buf != NULL) memcpy(grown, buf, len);
+        c_kzg_free(buf);
+        buf = grown;
+        len += fread(buf + len, 1, capacity - len, in);
+        if (len < capacity) break;
+        capacity *= 2;
+    }
+    if (ferror(in)) {
+        ret = C_KZG_BADARGS;
+        goto out;
+    }
+
+    ret = load_trusted_setup_from_buffer(out, buf, len);
+
+out:
+    c_kzg_free(buf);
+    return ret;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Shared Settings Images
+///////////////////////////////////////////////////////////////////////////////
+
+/** Identifies a settings image. Read back with the wrong byte order, it will not match. */
+#define SETTINGS_IMAGE_MAGIC 0x434b5a4753455453ULL
+
+/** Bump whenever the layout of an image, or of the types stored in it, changes. */
+#define SETTINGS_IMAGE_VERSION 1
+
+/** Each table in an image starts on a cache line. */
+#define SETTINGS_IMAGE_ALIGNMENT 64
+
+/**
+ * The header at the start of a settings image.
+ *
+ * An image holds no pointers, only offsets from its own start, so it can be mapped at any address.
+ */
+typedef struct {
+    uint64_t magic;                           /**< #SETTINGS_IMAGE_MAGIC */
+    uint64_t version;                         /**< #SETTINGS_IMAGE_VERSION */
+    uint64_t max_width;                       /**< The number of G1 points and of roots of unity */
+    uint64_t roots_of_unity_offset;           /**< Offset of FFTSettings::roots_of_unity */
+    uint64_t roots_of_unity_div_width_offset; /**< Offset of FFTSettings::roots_of_unity_div_width */
+    uint64_t g1_values_offset;                /**< Offset of KZGSettings::g1_values */
+    uint64_t g2_values_offset;                /**< Offset of KZGSettings::g2_values */
+    uint64_t size;                            /**< The total size of the image in bytes */
+} SettingsImageHeader;
+
+/**
+ * Round up to the next multiple of #SETTINGS_IMAGE_ALIGNMENT.
+ *
+ * @param[in] n The offset to align
+ * @return The aligned offset
+ */
+static uint64_t settings_image_align(uint64_t n) {
+    return (n + SETTINGS_IMAGE_ALIGNMENT - 1) & ~(uint64_t)(SETTINGS_IMAGE_ALIGNMENT - 1);
+}
+
+/**
+ * Compute the header of a settings image of the given width.
+ *
+ * The layout is fully determined by the width, so a reader checks an image by comparing its header to this one.
+ *
+ * @param[out] h         The header
+ * @param[in]  max_width The number of G1 points and of roots of unity
+ */
+static void settings_image_layout(SettingsImageHeader *h, uint64_t max_width) {
+    uint64_t offset = settings_image_align(sizeof(SettingsImageHeader));
+
+    h->magic = SETTINGS_IMAGE_MAGIC;
+    h->version = SETTINGS_IMAGE_VERSION;
+    h->max_width = max_width;
+    h->roots_of_unity_offset = offset;
+    offset = settings_image_align(offset + max_width * sizeof(fr_t));
+    h->roots_of_unity_div_width_offset = offset;
+    offset = settings_image_align(offset + max_width * sizeof(fr_t));
+    h->g1_values_offset = offset;
+    offset = settings_image_align(offset + max_width * sizeof(blst_p1_affine));
+    h->g2_values_offset = offset;
+    h->size = offset + NUM_G2_VALUES * sizeof(g2_t);
+}
+
+/**
+ * Write the settings into an image.
+ *
+ * @param[out] image The image, of size `h->size`
+ * @param[in]  h     The layout of the image, from #settings_image_layout
+ * @param[in]  s     The settings to write
+ */
+static void write_settings_image(uint8_t *image, const SettingsImageHeader *h, const KZGSettings *s) {
+    uint64_t width = h->max_width;
+
+    // Zero the padding too, so that the same settings always give the same image
+    memset(image, 0, h->size);
+    memcpy(image, h, sizeof *h);
+    memcpy(image + h->roots_of_unity_offset, s->fs->roots_of_unity, width * sizeof(fr_t));
+    memcpy(image + h->roots_of_unity_div_width_offset, s->fs->roots_of_unity_div_width, width * sizeof(fr_t));
+    memcpy(image + h->g1_values_offset, s->g1_values, width * sizeof(blst_p1_affine));
+    memcpy(image + h->g2_values_offset, s->g2_values, NUM_G2_VALUES * sizeof(g2_t));
+}
+
+/**
+ * Point settings into an image.
+ *
+ * @param[out] out        The settings
+ * @param[out] fs         The FFT settings for @p out to own
+ * @param[in]  image      The image, checked against @p h
+ * @param[in]  image_size The size of the mapping at @p image
+ * @param[in]  h          The layout of the image, from #settings_image_layout
+ */
+static void settings_from_image(KZGSettings *out, FFTSettings *fs, const uint8_t *image, size_t image_size,
+                                const SettingsImageHeader *h) {
+    fs->max_width = h->max_width;
+    fs->roots_of_unity = (const fr_t *)(image + h->roots_of_unity_offset);
+    fs->roots_of_unity_div_width = (const fr_t *)(image + h->roots_of_unity_div_width_offset);
+
+    out->fs = fs;
+    out->g1_values = (const blst_p1_affine *)(image + h->g1_values_offset);
+    out->g2_values = (const g2_t *)(image + h->g2_values_offset);
+    out->image = image;
+    out->image_size = image_size;
+    out->replicas = NULL;
+    out->num_replicas = 0;
+    out->executor = NULL;
+}
+
+/**
+ * Map a settings image file read-only.
+ *
+ * Where `mmap()` is not available, the file is read into the heap instead. That still skips the work of
+ * #load_trusted_setup, but the memory is not shared.
+ *
+ * @remark Release with #unmap_settings_image.
+ *
+ * @param[out] out  The start of the image
+ * @param[out] size The size of the image in bytes
+ * @param[in]  path The file to map
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS The file could not be opened
+ * @retval C_CZK_ERROR   The file could not be mapped or read
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+static C_KZG_RET map_settings_image(const void **out, size_t *size, const char *path) {
+#ifdef _WIN32
+    C_KZG_RET ret;
+    void *image = NULL;
+    long length;
+    FILE *f = fopen(path, "rb");
+
+    if (f == NULL) return C_KZG_BADARGS;
+    if (fseek(f, 0, SEEK_END) != 0 || (length = ftell(f)) < 0 || fseek(f, 0, SEEK_SET) != 0) {
+        ret = C_KZG_ERROR;
+        goto out;
+    }
+    ret = c_kzg_malloc(&image, (size_t)length);
+    if (ret != C_KZG_OK) goto out;
+    if (fread(image, 1, (size_t)length, f) != (size_t)length) {
+        c_kzg_free(image);
+        ret = C_KZG_ERROR;
+        goto out;
+    }
+    *out = image;
+    *size = (size_t)length;
+
+out:
+    fclose(f);
+    return ret;
+#else
+    struct stat st;
+    void *image;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0) return C_KZG_BADARGS;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return C_KZG_BADARGS;
+    }
+    image = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+    if (image == MAP_FAILED) return C_KZG_ERROR;
+
+    *out = image;
+    *size = (size_t)st.st_size;
+    return C_KZG_OK;
+#endif
+}
+
+/**
+ * Release an image mapped by #map_settings_image.
+ *
+ * @param[in] image The start of the image
+ * @param[in] size  The size of the image in bytes
+ */
+static void unmap_settings_image(const void *image, size_t size) {
+#ifdef _WIN32
+    (void)size;
+    c_kzg_free((void *)image);
+#else
+    munmap((void *)image, size);
+#endif
+}
+
+/**
+ * Write a settings image for other processes to attach with #attach_trusted_setup.
+ *
+ * The image is written to a new, uniquely named file next to @p path and then renamed over it, so a process attaching
+ * concurrently sees either the previous image or the complete new one, and concurrent publishers do not write to the
+ * same file. The temporary file is created exclusively, so a link planted in its place is never followed. To share the
+ * image through POSIX shared memory rather than a file on disk, place it on a memory-backed file system such as
+ * `/dev/shm`.
+ *
+ * @remark Attaching does not re-validate the points in the image, so only publish to a location that untrusted users
+ * cannot write to.
+ *
+ * @param[in] path Where to write the image
+ * @param[in] s    The settings, previously initialised with #load_trusted_setup
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS The file could not be created
+ * @retval C_CZK_ERROR   The file could not be written
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET publish_trusted_setup(const char *path, const KZGSettings *s) {
+    C_KZG_RET ret;
+    SettingsImageHeader h;
+    uint8_t *image = NULL;
+    char *tmp_path = NULL;
+    size_t path_len = strlen(path);
+
+    settings_image_layout(&h, s->fs->max_width);
+    ret = c_kzg_malloc((void **)&image, h.size);
+    if (ret != C_KZG_OK) goto out;
+    ret = c_kzg_malloc((void **)&tmp_path, path_len + sizeof ".XXXXXX");
+    if (ret != C_KZG_OK) goto out;
+
+    write_settings_image(image, &h, s);
+    memcpy(tmp_path, path, path_len);
+    memcpy(tmp_path + path_len, ".XXXXXX", sizeof ".XXXXXX");
+
+#ifdef _WIN32
+    // There is no mkstemp here; _mktemp_s picks an unused name, which fopen's "x" mode then creates exclusively
+    FILE *f = NULL;
+    if (_mktemp_s(tmp_path, path_len + sizeof ".XXXXXX") == 0) f = fopen(tmp_path, "wbx");
+    if (f == NULL) {
+        ret = C_KZG_BADARGS;
+        goto out;
+    }
+    if (fwrite(image, 1, h.size, f) != h.size) ret = C_KZG_ERROR;
+    if (fclose(f) != 0) ret = C_KZG_ERROR;
+#else
+    // mkstemp creates the file with O_EXCL under a fresh name, so it neither follows links nor collides
+    int fd = mkstemp(tmp_path);
+    if (fd < 0) {
+        ret = C_KZG_BADARGS;
+        goto out;
+    }
+    // Other users attach the image read-only, as they could a file from fopen
+    if (fchmod(fd, 0644) != 0) ret = C_KZG_ERROR;
+    for (size_t written = 0; ret == C_KZG_OK && written < h.size;) {
+        ssize_t n = write(fd, image + written, h.size - written);
+        if (n < 0) {
+            if (errno != EINTR) ret = C_KZG_ERROR;
+        } else {
+            written += (size_t)n;
+        }
+    }
+    if (close(fd) != 0) ret = C_KZG_ERROR;
+#endif
+    if (ret != C_KZG_OK) {
+        remove(tmp_path);
+        goto out;
+    }
+
+#ifdef _WIN32
+    // rename() does not replace an existing file here
+    remove(path);
+#endif
+    if (rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        ret = C_KZG_ERROR;
+    }
+
+out:
+    c_kzg_free(image);
+    c_kzg_free(tmp_path);
+    return ret;
+}
+
+/**
+ * Attach to a settings image written by #publish_trusted_setup.
+ *
+ * The image is mapped read-only and shared, and the settings point straight into it. Only the header is checked, so
+ * attaching costs a system call or two rather than the curve arithmetic in #load_trusted_setup, and the physical
+ * memory is paid for once however many processes attach.
+ *
+ * @remark Free after use with #free_trusted_setup.
+ *
+ * @param[out] out  The attached settings
+ * @param[in]  path The image to attach
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS The file could not be opened, or is not an image for this build
+ * @retval C_CZK_ERROR   The file could not be mapped or read
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET attach_trusted_setup(KZGSettings *out, const char *path) {
+    C_KZG_RET ret;
+    SettingsImageHeader expected;
+    FFTSettings *fs = NULL;
+    const uint8_t *image;
+    size_t size;
+
+    out->fs = NULL;
+    out->g1_values = NULL;
+    out->g2_values = NULL;
+    out->image = NULL;
+    out->image_size = 0;
+    out->replicas = NULL;
+    out->num_replicas = 0;
+    out->executor = NULL;
+
+    ret = map_settings_image((const void **)&image, &size, path);
+    if (ret != C_KZG_OK) return ret;
+
+    // The width comes from the image, and the rest of the header must be what that width implies
+    if (size < sizeof expected) {
+        ret = C_KZG_BADARGS;
+        goto out_error;
+    }
+    uint64_t width = ((const SettingsImageHeader *)image)->max_width;
+    if (width > FIELD_ELEMENTS_PER_BLOB || !is_power_of_two(width)) {
+        ret = C_KZG_BADARGS;
+        goto out_error;
+    }
+    settings_image_layout(&expected, width);
+    if (size != expected.size || memcmp(image, &expected, sizeof expected) != 0) {
+        ret = C_KZG_BADARGS;
+        goto out_error;
+    }
+
+    ret = c_kzg_malloc((void **)&fs, sizeof(FFTSettings));
+    if (ret != C_KZG_OK) goto out_error;
+    settings_from_image(out, fs, image, size, &expected);
+    return C_KZG_OK;
+
+out_error:
+    unmap_settings_image(image, size);
+    return ret;
+}
+
+/**
+ * Free settings that point into an image, from #attach_trusted_setup or #place_trusted_setup.
+ *
+ * @param s The settings to be freed
+ */
+static void detach_trusted_setup(KZGSettings *s) {
+    c_kzg_free((FFTSettings *)s->fs);
+    unmap_settings_image(s->image, s->image_size);
+    s->image = NULL;
+    s->image_size = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Settings Placement
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef __linux__
+
+/** The size of a transparent or reserved huge page. */
+#define HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+/** The most NUMA nodes that settings are replicated to, the bits in one node mask word. */
+#define MAX_NUMA_NODES (8 * sizeof(unsigned long))
+
+/** The `MPOL_PREFERRED` memory policy from the kernel's `mempolicy.h`, which libc does not define. */
+#define MEMPOLICY_PREFERRED 1
+
+/**
+ * Count the NUMA nodes in a kernel node list, such as `0`, `0-3` or `0,2-3`.
+ *
+ * Node numbers may have gaps, so the count is the highest node number plus one rather than the number of nodes listed.
+ *
+ * @param[in] f The list, as in `/sys/devices/system/node/possible`
+ * @return The number of nodes, at least one and at most #MAX_NUMA_NODES
+ */
+STATIC size_t numa_node_count_from_list(FILE *f) {
+    unsigned int first, last;
+    size_t count = 1;
+    int c;
+
+    // Comma-separated nodes and ranges of nodes
+    while (fscanf(f, "%u", &first) == 1) {
+        last = first;
+        c = fgetc(f);
+        if (c == '-') {
+            if (fscanf(f, "%u", &last) != 1) break;
+            c = fgetc(f);
+        }
+        if ((size_t)last + 1 > count) count = (size_t)last + 1;
+        if (c != ',') break;
+    }
+
+    return count < MAX_NUMA_NODES ? count : MAX_NUMA_NODES;
+}
+
+/**
+ * Count the NUMA nodes this machine can have.
+ *
+ * @return The number of nodes, at least one and at most #MAX_NUMA_NODES
+ */
+static size_t numa_node_count(void) {
+    size_t count;
+    FILE *f = fopen("/sys/devices/system/node/possible", "r");
+
+    if (f == NULL) return 1;
+    count = numa_node_count_from_list(f);
+    fclose(f);
+
+    return count;
+}
+
+/**
+ * Map private memory for a settings image.
+ *
+ * Huge pages and the node are requests rather than requirements: if the kernel cannot honour them, the image is placed
+ * in ordinary pages wherever the kernel chooses.
+ *
+ * @remark Release with #unmap_settings_image.
+ *
+ * @param[out] out   The start of the mapping
+ * @param[out] size  The size of the mapping, @p n rounded up to whole huge pages if they were asked for
+ * @param[in]  n     The size of the image
+ * @param[in]  flags The `KZG_PLACE_*` flags
+ * @param[in]  node  The NUMA node to place the mapping on, or -1 for any
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+static C_KZG_RET map_placed_image(uint8_t **out, size_t *size, size_t n, unsigned int flags, int node) {
+    bool huge = (flags & (KZG_PLACE_HUGE_PAGES | KZG_PLACE_EXPLICIT_HUGE_PAGES)) != 0;
+    size_t len = huge ? (n + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1) : n;
+    uint8_t *image = MAP_FAILED;
+
+    if (flags & KZG_PLACE_EXPLICIT_HUGE_PAGES) {
+        image = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+    if (image == MAP_FAILED && huge) {
+        // Over-allocate, so that the image can start on a huge page boundary, and trim the excess
+        uint8_t *raw = mmap(NULL, len + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) return C_KZG_MALLOC;
+        image = (uint8_t *)(((uintptr_t)raw + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1));
+        if (image != raw) munmap(raw, image - raw);
+        munmap(image + len, raw + HUGE_PAGE_SIZE - image);
+        madvise(image, len, MADV_HUGEPAGE);
+    }
+    if (image == MAP_FAILED) {
+        image = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (image == MAP_FAILED) return C_KZG_MALLOC;
+    }
+
+    if (node >= 0) {
+        // The pages are not touched yet, so they are allocated on the node when the image is written. The kernel
+        // reads one bit fewer than the mask size it is given.
+        unsigned long mask = 1UL << node;
+        syscall(SYS_mbind, image, len, MEMPOLICY_PREFERRED, &mask, MAX_NUMA_NODES + 1, 0);
+    }
+
+    *out = image;
+    *size = len;
+    return C_KZG_OK;
+}
+
+/**
+ * Copy settings into a read-only image placed according to the given flags.
+ *
+ * @remark Free with #detach_trusted_setup.
+ *
+ * @param[out] out   The placed copy
+ * @param[in]  s     The settings to copy
+ * @param[in]  flags The `KZG_PLACE_*` flags
+ * @param[in]  node  The NUMA node to place the copy on, or -1 for any
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+static C_KZG_RET new_placed_settings(KZGSettings *out, const KZGSettings *s, unsigned int flags, int node) {
+    C_KZG_RET ret;
+    SettingsImageHeader h;
+    FFTSettings *fs = NULL;
+    uint8_t *image;
+    size_t size;
+
+    settings_image_layout(&h, s->fs->max_width);
+    ret = c_kzg_malloc((void **)&fs, sizeof(FFTSettings));
+    if (ret != C_KZG_OK) return ret;
+    ret = map_placed_image(&image, &size, h.size, flags, node);
+    if (ret != C_KZG_OK) {
+        c_kzg_free(fs);
+        return ret;
+    }
+
+    write_settings_image(image, &h, s);
+    mprotect(image, size, PROT_READ);
+    settings_from_image(out, fs, image, size, &h);
+    return C_KZG_OK;
+}
+
+#endif /* defined(__linux__) */
+
+/**
+ * Move the tables of loaded settings to where the hot paths read them fastest.
+ *
+ * The commitment key is read on every MSM. With #KZG_PLACE_HUGE_PAGES the tables move into a read-only mapping backed
+ * by a transparent huge page, so that the whole key sits behind a single TLB entry; this costs the rest of the 2 MiB
+ * page. #KZG_PLACE_EXPLICIT_HUGE_PAGES uses a page reserved through `vm.nr_hugepages` instead, if there is one.
+ *
+ * With #KZG_PLACE_NUMA_REPLICAS the tables are also copied to every NUMA node, and each call uses the copy on the
+ * node of the calling thread. This avoids remote memory reads on multi-socket machines, at the cost of one copy of the
+ * tables per node. It does nothing on a machine with a single node.
+ *
+ * Placement is only available on Linux; elsewhere this succeeds without changing anything.
+ *
+ * @remark The settings must have come from #load_trusted_setup, and not have been placed already. On failure they
+ * remain usable.
+ *
+ * @param[in,out] s     The settings to place
+ * @param[in]     flags The `KZG_PLACE_*` flags
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_BADARGS The settings were attached or placed already
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET place_trusted_setup(KZGSettings *s, unsigned int flags) {
+    CHECK(s->image == NULL && s->replicas == NULL);
+
+#ifdef __linux__
+    C_KZG_RET ret;
+    const KZGExecutor *executor = s->executor;
+    KZGSettings placed;
+    KZGSettings *replicas = NULL;
+    size_t i, num_nodes;
+
+    if (flags & (KZG_PLACE_HUGE_PAGES | KZG_PLACE_EXPLICIT_HUGE_PAGES)) {
+        ret = new_placed_settings(&placed, s, flags, -1);
+        if (ret != C_KZG_OK) return ret;
+        free_trusted_setup(s);
+        *s = placed;
+        s->executor = executor;
+    }
+
+    if (flags & KZG_PLACE_NUMA_REPLICAS) {
+        num_nodes = numa_node_count();
+        if (num_nodes < 2) return C_KZG_OK;
+
+        ret = c_kzg_malloc((void **)&replicas, num_nodes * sizeof(KZGSettings));
+        if (ret != C_KZG_OK) return ret;
+        for (i = 0; i < num_nodes; i++) {
+            ret = new_placed_settings(&replicas[i], s, flags, (int)i);
+            if (ret != C_KZG_OK) {
+                while (i-- > 0) detach_trusted_setup(&replicas[i]);
+                c_kzg_free(replicas);
+                return ret;
+            }
+        }
+        s->replicas = replicas;
+        s->num_replicas = num_nodes;
+        set_trusted_setup_executor(s, executor);
+    }
+#else
+    (void)flags;
+#endif
+
+    return C_KZG_OK;
 }
 
 /*
  * Free a trusted setup (KZGSettings).
  */
 void free_trusted_setup(KZGSettings *s) {
+    for (size_t i = 0; i < s->num_replicas; i++) {
+        detach_trusted_setup(&s->replicas[i]);
+    }
+    c_kzg_free(s->replicas);
+    s->replicas = NULL;
+    s->num_replicas = 0;
+
+    if (s->image != NULL) {
+        detach_trusted_setup(s);
+        return;
+    }
     free_fft_settings((FFTSettings*)s->fs);
     free_kzg_settings(s);
 }
+
+///////////////////////////////////////////////////////////////////////////////
+// Asynchronous Loading
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A trusted setup being loaded in the background.
+ */
+struct KZGSettingsLoader {
+    KZGSettings settings; /**< The settings, valid once loading is done and succeeded */
+    C_KZG_RET ret;        /**< The result of loading, valid once loading is done */
+    char *path;           /**< The trusted setup file */
+#ifndef _WIN32
+    pthread_t thread;     /**< The thread doing the loading */
+    pthread_mutex_t lock; /**< Guards `done` */
+    pthread_cond_t cond;  /**< Signalled when `done` is set */
+#endif
+    bool done;            /**< Whether loading has finished */
+};
+
+/**
+ * Load the trusted setup for a loader, on whichever thread runs this.
+ *
+ * @param[in,out] l The loader
+ */
+static void run_trusted_setup_loader(KZGSettingsLoader *l) {
+    FILE *in = fopen(l->path, "r");
+    if (in == NULL) {
+        l->ret = C_KZG_BADARGS;
+    } else {
+        l->ret = load_trusted_setup_file(&l->settings, in);
+        fclose(in);
+    }
+}
+
+#ifndef _WIN32
+/**
+ * The entry point of the loading thread.
+ *
+ * @param[in,out] arg The loader
+ * @return NULL
+ */
+static void *trusted_setup_loader_thread(void *arg) {
+    KZGSettingsLoader *l = arg;
+
+    run_trusted_setup_loader(l);
+
+    pthread_mutex_lock(&l->lock);
+    l->done = true;
+    pthread_cond_broadcast(&l->cond);
+    pthread_mutex_unlock(&l->lock);
+    return NULL;
+}
+#endif
+
+/**
+ * Start loading a trusted setup file in the background.
+ *
+ * Parsing, validation and the IFFT happen on a new thread, and this returns straight away. Use
+ * #wait_trusted_setup to get the settings, which blocks only if they are not ready yet, so it can be called before
+ * every KZG function instead of once at startup.
+ *
+ * Where threads are not available, the file is loaded before this returns.
+ *
+ * @remark Free after use with #free_trusted_setup_loader, which also frees the settings.
+ *
+ * @param[out] out  The new loader
+ * @param[in]  path The trusted setup file, in the format read by #load_trusted_setup_file
+ * @retval C_CZK_OK      Loading has started. Its own result is reported by #wait_trusted_setup.
+ * @retval C_CZK_ERROR   The loading thread could not be started
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET load_trusted_setup_file_async(KZGSettingsLoader **out, const char *path) {
+    C_KZG_RET ret;
+    KZGSettingsLoader *l = NULL;
+    size_t path_size = strlen(path) + 1;
+
+    *out = NULL;
+
+    ret = c_kzg_malloc((void **)&l, sizeof(KZGSettingsLoader));
+    if (ret != C_KZG_OK) return ret;
+    ret = c_kzg_malloc((void **)&l->path, path_size);
+    if (ret != C_KZG_OK) {
+        c_kzg_free(l);
+        return ret;
+    }
+    memcpy(l->path, path, path_size);
+    l->ret = C_KZG_ERROR;
+    l->done = false;
+
+#ifdef _WIN32
+    run_trusted_setup_loader(l);
+    l->done = true;
+#else
+    pthread_mutex_init(&l->lock, NULL);
+    pthread_cond_init(&l->cond, NULL);
+    if (pthread_create(&l->thread, NULL, trusted_setup_loader_thread, l) != 0) {
+        pthread_mutex_destroy(&l->lock);
+        pthread_cond_destroy(&l->cond);
+        c_kzg_free(l->path);
+        c_kzg_free(l);
+        return C_KZG_ERROR;
+    }
+#endif
+
+    *out = l;
+    return C_KZG_OK;
+}
+
+/**
+ * Check, without blocking, whether a background load has finished.
+ *
+ * @param[in] l The loader
+ * @retval true  #wait_trusted_setup will return immediately
+ * @retval false The trusted setup is still loading
+ */
+bool trusted_setup_is_ready(KZGSettingsLoader *l) {
+#ifdef _WIN32
+    return l->done;
+#else
+    bool done;
+    pthread_mutex_lock(&l->lock);
+    done = l->done;
+    pthread_mutex_unlock(&l->lock);
+    return done;
+#endif
+}
+
+/**
+ * Get the settings from a background load, blocking until it has finished.
+ *
+ * @param[out] out The settings, owned by the loader, or NULL if loading failed
+ * @param[in]  l   The loader
+ * @return The result of loading the trusted setup, as from #load_trusted_setup_file, or #C_KZG_BADARGS if the file
+ * could not be opened
+ */
+C_KZG_RET wait_trusted_setup(const KZGSettings **out, KZGSettingsLoader *l) {
+#ifndef _WIN32
+    pthread_mutex_lock(&l->lock);
+    while (!l->done) pthread_cond_wait(&l->cond, &l->lock);
+    pthread_mutex_unlock(&l->lock);
+#endif
+    *out = l->ret == C_KZG_OK ? &l->settings : NULL;
+    return l->ret;
+}
+
+/**
+ * Free a loader and the settings it loaded.
+ *
+ * If the load is still running, this waits for it to finish first.
+ *
+ * @param l The loader to be freed
+ */
+void free_trusted_setup_loader(KZGSettingsLoader *l) {
+    if (l == NULL) return;
+#ifndef _WIN32
+    pthread_join(l->thread, NULL);
+    pthread_mutex_destroy(&l->lock);
+    pthread_cond_destroy(&l->cond);
+#endif
+    if (l->ret == C_KZG_OK) free_trusted_setup(&l->settings);
+    c_kzg_free(l->path);
+    c_kzg_free(l);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Parallel Execution
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Run the parallel loops of some settings on an executor.
+ *
+ * Batch functions split their work into one task per blob or evaluation point, and large MSMs are split into chunks,
+ * all through @p executor. Hosts with their own scheduler can pass an executor backed by it, so that the library does
+ * not compete with it for cores; otherwise #new_kzg_thread_pool provides one.
+ *
+ * @remark The executor must outlive its use by the settings. Any NUMA replicas of the settings use it too.
+ *
+ * @param[in,out] s        The settings
+ * @param[in]     executor The executor, or NULL to run everything on the calling thread
+ */
+void set_trusted_setup_executor(KZGSettings *s, const KZGExecutor *executor) {
+    s->executor = executor;
+    for (size_t i = 0; i < s->num_replicas; i++) {
+        s->replicas[i].executor = executor;
+    }
+}
+
+/**
+ * A fixed set of threads that run one parallel loop at a time.
+ */
+typedef struct {
+    KZGExecutor executor;       /**< The executor handed out, first so that the pool can be found from it */
+#ifndef _WIN32
+    pthread_mutex_t lock;       /**< Guards everything below */
+    pthread_cond_t work_ready;  /**< Signalled when a loop starts, or the pool is stopping */
+    pthread_cond_t work_done;   /**< Signalled when the last running task of a loop returns */
+    pthread_t *threads;         /**< The worker threads */
+    size_t num_workers;         /**< The number of `threads` that were started */
+    kzg_task_fn fn;             /**< The task of the current loop */
+    void *arg;                  /**< The argument of the current loop */
+    size_t n;                   /**< The number of indices of the current loop */
+    size_t next;                /**< The next index to be taken */
+    size_t running;             /**< The number of tasks being run by workers */
+    bool busy;                  /**< Whether a loop is in progress */
+    bool stopping;              /**< Whether the workers should exit */
+#endif
+} ThreadPool;
+
+/**
+ * A `parallel_for` that runs every task on the calling thread.
+ *
+ * @param[in] ctx Unused
+ * @param[in] fn  The task
+ * @param[in] arg The argument of @p fn
+ * @param[in] n   The number of indices
+ */
+static void serial_parallel_for(void *ctx, kzg_task_fn fn, void *arg, size_t n) {
+    (void)ctx;
+    for (size_t i = 0; i < n; i++) {
+        fn(arg, i);
+    }
+}
+
+#ifndef _WIN32
+/**
+ * The entry point of a worker thread, which takes tasks from the current loop until the pool stops.
+ *
+ * @param[in,out] arg The pool
+ * @return NULL
+ */
+static void *thread_pool_worker(void *arg) {
+    ThreadPool *pool = arg;
+
+    pthread_mutex_lock(&pool->lock);
+    while (true) {
+        while (!pool->stopping && !(pool->busy && pool->next < pool->n)) {
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        }
+        if (pool->stopping) break;
+
+        kzg_task_fn fn = pool->fn;
+        void *fn_arg = pool->arg;
+        size_t i = pool->next++;
+        pool->running++;
+        pthread_mutex_unlock(&pool->lock);
+
+        fn(fn_arg, i);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->running == 0 && pool->next >= pool->n) {
+            pthread_cond_signal(&pool->work_done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    release_kzg_thread_scratch();
+    return NULL;
+}
+
+/**
+ * The `parallel_for` of a thread pool.
+ *
+ * Idle workers and the calling thread take indices from a shared counter, one at a time, so a slow task never holds
+ * up the others. The pool runs one loop at a time: a loop started while another is in progress, including one started
+ * from within a task, runs on the calling thread instead of waiting.
+ *
+ * @param[in] ctx The pool
+ * @param[in] fn  The task
+ * @param[in] arg The argument of @p fn
+ * @param[in] n   The number of indices
+ */
+static void thread_pool_parallel_for(void *ctx, kzg_task_fn fn, void *arg, size_t n) {
+    ThreadPool *pool = ctx;
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->busy) {
+        pthread_mutex_unlock(&pool->lock);
+        serial_parallel_for(NULL, fn, arg, n);
+        return;
+    }
+    pool->busy = true;
+    pool->fn = fn;
+    pool->arg = arg;
+    pool->n = n;
+    pool->next = 0;
+    pthread_cond_broadcast(&pool->work_ready);
+
+    while (pool->next < n) {
+        size_t i = pool->next++;
+        pthread_mutex_unlock(&pool->lock);
+        fn(arg, i);
+        pthread_mutex_lock(&pool->lock);
+    }
+    while (pool->running > 0) {
+        pthread_cond_wait(&pool->work_done, &pool->lock);
+    }
+    pool->busy = false;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Stop and join the workers of a pool.
+ *
+ * @param[in,out] pool The pool
+ */
+static void stop_thread_pool(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+    for (size_t i = 0; i < pool->num_workers; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+}
+#endif
+
+/**
+ * Create the default executor, a pool of threads.
+ *
+ * The calling thread of each loop takes part in it, so a pool of @p num_threads starts one fewer worker. Where threads
+ * are not available, the executor runs everything on the calling thread.
+ *
+ * @remark Free after use with #free_kzg_thread_pool, once no settings use it.
+ *
+ * @param[out] out         The new executor
+ * @param[in]  num_threads The number of threads to run tasks on, or 0 for one per online CPU
+ * @retval C_CZK_OK      All is well
+ * @retval C_CZK_ERROR   A worker thread could not be started
+ * @retval C_CZK_MALLOC  Memory allocation failed
+ */
+C_KZG_RET new_kzg_thread_pool(KZGExecutor **out, size_t num_threads) {
+    C_KZG_RET ret;
+    ThreadPool *pool = NULL;
+
+    *out = NULL;
+
+    ret = c_kzg_malloc((void **)&pool, sizeof(ThreadPool));
+    if (ret != C_KZG_OK) return ret;
+    pool->executor.ctx = pool;
+
+#ifdef _WIN32
+    (void)num_threads;
+    pool->executor.parallel_for = serial_parallel_for;
+    pool->executor.num_threads = 1;
+#else
+    if (num_threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = online > 0 ? (size_t)online : 1;
+    }
+    pool->executor.parallel_for = thread_pool_parallel_for;
+    pool->executor.num_threads = num_threads;
+    pool->threads = NULL;
+    pool->num_workers = 0;
+    pool->n = 0;
+    pool->next = 0;
+    pool->running = 0;
+    pool->busy = false;
+    pool->stopping = false;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+
+    if (num_threads > 1) {
+        ret = c_kzg_malloc((void **)&pool->threads, (num_threads - 1) * sizeof(pthread_t));
+        if (ret != C_KZG_OK) goto out_error;
+        for (; pool->num_workers < num_threads - 1; pool->num_workers++) {
+            if (pthread_create(&pool->threads[pool->num_workers], NULL, thread_pool_worker, pool) != 0) {
+                ret = C_KZG_ERROR;
+                goto out_error;
+            }
+        }
+    }
+#endif
+
+    *out = &pool->executor;
+    return C_KZG_OK;
+
+#ifndef _WIN32
+out_error:
+    stop_thread_pool(pool);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_cond_destroy(&pool->work_done);
+    c_kzg_free(pool->threads);
+    c_kzg_free(pool);
+    return ret;
+#endif
+}
+
+/**
+ * Stop the threads of an executor from #new_kzg_thread_pool, and free it.
+ *
+ * @param pool The executor to be freed
+ */
+void free_kzg_thread_pool(KZGExecutor *pool) {
+    if (pool == NULL) return;
+    ThreadPool *p = pool->ctx;
+#ifndef _WIN32
+    stop_thread_pool(p);
+    pthread_mutex_destroy(&p->lock);
+    pthread_cond_destroy(&p->work_ready);
+    pthread_cond_destroy(&p->work_done);
+    c_kzg_free(p->threads);
+#endif
+    c_kzg_free(p);
+}
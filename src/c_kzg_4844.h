@@ -37,6 +37,8 @@ extern "C" {
 #define BYTES_PER_COMMITMENT 48
 #define BYTES_PER_PROOF 48
 #define BYTES_PER_FIELD_ELEMENT 32
+// The largest blob size supported. Smaller presets are picked at runtime by the trusted setup that is loaded, see
+// kzg_settings_field_elements_per_blob().
 #define BYTES_PER_BLOB (FIELD_ELEMENTS_PER_BLOB * BYTES_PER_FIELD_ELEMENT)
 static const char *FIAT_SHAMIR_PROTOCOL_DOMAIN = "FSBLOBVERIFY_V1_";
 
@@ -65,25 +67,72 @@ typedef enum {
  * Stores the setup and parameters needed for performing FFTs.
  */
 typedef struct {
-    uint64_t max_width;            /**< The maximum size of FFT these settings support, a power of 2. */
-    fr_t *expanded_roots_of_unity; /**< Ascending powers of the root of unity, size `width + 1`. */
-    fr_t *reverse_roots_of_unity;  /**< Descending powers of the root of unity, size `width + 1`. */
-    fr_t *roots_of_unity;          /**< Powers of the root of unity in bit-reversal permutation, size `width`. */
+    uint64_t max_width;                   /**< The maximum size of FFT these settings support, a power of 2. */
+    const fr_t *roots_of_unity;           /**< Powers of the root of unity in bit-reversal permutation, size `width`. */
+    const fr_t *roots_of_unity_div_width; /**< The bit-reversal permuted powers, each divided by `width`, size `width`. */
 } FFTSettings;
 
+/**
+ * Where the library gets its memory from, see #set_kzg_allocator.
+ *
+ * `malloc_fn` and `calloc_fn` return space aligned to `alignment`, a power of two, or NULL on failure; `calloc_fn` also
+ * zeroes it. `free_fn` releases space from either, and is never passed NULL. All three may be called concurrently.
+ */
+typedef struct KZGAllocator {
+    void *(*malloc_fn)(void *ctx, size_t size, size_t alignment);               /**< Allocate */
+    void *(*calloc_fn)(void *ctx, size_t count, size_t size, size_t alignment); /**< Allocate zeroed space */
+    void (*free_fn)(void *ctx, void *p);                                        /**< Release */
+    void *ctx;                                                                  /**< Passed to each function */
+} KZGAllocator;
+
+/**
+ * A function run by an executor for each index of a parallel loop.
+ */
+typedef void (*kzg_task_fn)(void *arg, size_t i);
+
+/**
+ * Runs the parallel loops of the library on the host's threads, see #set_trusted_setup_executor.
+ *
+ * `parallel_for` must call `fn(arg, i)` exactly once for every `i` in `[0, n)`, in any order and on any threads, and
+ * return once all of those calls have returned. It may be called concurrently, and from within `fn`.
+ */
+typedef struct KZGExecutor {
+    void (*parallel_for)(void *ctx, kzg_task_fn fn, void *arg, size_t n); /**< Run a parallel loop */
+    void *ctx;                                                             /**< Passed to `parallel_for` */
+    size_t num_threads;                                                    /**< How many tasks can usefully run at once */
+} KZGExecutor;
+
 /**
  * Stores the setup and parameters needed for computing KZG proofs.
  */
-typedef struct {
-    const FFTSettings *fs; /**< The corresponding settings for performing FFTs */
-    g1_t *g1_values;       /**< G1 group elements from the trusted setup, in Lagrange form bit-reversal permutation */
-    g2_t *g2_values;       /**< G2 group elements from the trusted setup; both arrays have FIELD_ELEMENTS_PER_BLOB elements */
+typedef struct KZGSettings {
+    const FFTSettings *fs;            /**< The corresponding settings for performing FFTs */
+    const blst_p1_affine *g1_values;  /**< Affine G1 group elements from the trusted setup, in Lagrange form bit-reversal permutation */
+    const g2_t *g2_values;            /**< The first two G2 group elements from the trusted setup, `[1]` and `[s]` */
+    const void *image;                /**< The settings image the tables point into, or NULL if they are on the heap */
+    size_t image_size;                /**< The size of the mapping at `image` */
+    struct KZGSettings *replicas;     /**< Copies of these settings indexed by NUMA node, or NULL */
+    size_t num_replicas;              /**< The number of `replicas` */
+    const KZGExecutor *executor;      /**< Runs the parallel loops, or NULL to run them on the calling thread */
 } KZGSettings;
 
+#define KZG_PLACE_HUGE_PAGES 1          /**< Back the tables with transparent huge pages */
+#define KZG_PLACE_EXPLICIT_HUGE_PAGES 2 /**< Back the tables with reserved huge pages, else transparent ones */
+#define KZG_PLACE_NUMA_REPLICAS 4       /**< Copy the tables to every NUMA node */
+
+/**
+ * A trusted setup being loaded in the background, see #load_trusted_setup_file_async.
+ */
+typedef struct KZGSettingsLoader KZGSettingsLoader;
+
 /**
  * Interface functions
  */
 
+void set_kzg_allocator(const KZGAllocator *allocator);
+
+void release_kzg_thread_scratch(void);
+
 C_KZG_RET load_trusted_setup(KZGSettings *out,
                              const uint8_t *g1_bytes, /* n1 * 48 bytes */
                              size_t n1,
@@ -93,9 +142,44 @@ C_KZG_RET load_trusted_setup(KZGSettings *out,
 C_KZG_RET load_trusted_setup_file(KZGSettings *out,
                                   FILE *in);
 
+C_KZG_RET load_trusted_setup_from_buffer(KZGSettings *out,
+                                         const char *buf,
+                                         size_t len);
+
 void free_trusted_setup(
     KZGSettings *s);
 
+size_t kzg_settings_memory_usage(const KZGSettings *s);
+
+uint64_t kzg_settings_field_elements_per_blob(const KZGSettings *s);
+
+C_KZG_RET publish_trusted_setup(const char *path,
+                                const KZGSettings *s);
+
+C_KZG_RET attach_trusted_setup(KZGSettings *out,
+                               const char *path);
+
+C_KZG_RET place_trusted_setup(KZGSettings *s,
+                              unsigned int flags);
+
+void set_trusted_setup_executor(KZGSettings *s,
+                                const KZGExecutor *executor);
+
+C_KZG_RET new_kzg_thread_pool(KZGExecutor **out,
+                              size_t num_threads);
+
+void free_kzg_thread_pool(KZGExecutor *pool);
+
+C_KZG_RET load_trusted_setup_file_async(KZGSettingsLoader **out,
+                                        const char *path);
+
+bool trusted_setup_is_ready(KZGSettingsLoader *l);
+
+C_KZG_RET wait_trusted_setup(const KZGSettings **out,
+                             KZGSettingsLoader *l);
+
+void free_trusted_setup_loader(KZGSettingsLoader *l);
+
 C_KZG_RET compute_aggregate_kzg_proof(KZGProof *out,
                                       const Blob *blobs,
                                       size_t n,
@@ -112,6 +196,11 @@ C_KZG_RET blob_to_kzg_commitment(KZGCommitment *out,
                                  const Blob *blob,
                                  const KZGSettings *s);
 
+C_KZG_RET blob_to_kzg_commitment_with_sparsity(KZGCommitment *out,
+                                               uint64_t *nonzero_out,
+                                               const Blob *blob,
+                                               const KZGSettings *s);
+
 C_KZG_RET verify_kzg_proof(bool *out,
                            const Bytes48 *commitment_bytes,
                            const Bytes32 *z_bytes,
@@ -124,6 +213,19 @@ C_KZG_RET compute_kzg_proof(KZGProof *out,
                             const Bytes32 *z_bytes,
                             const KZGSettings *s);
 
+C_KZG_RET evaluate_blob_at_points(Bytes32 *ys,
+                                  const Blob *blob,
+                                  const Bytes32 *xs_bytes,
+                                  size_t k,
+                                  const KZGSettings *s);
+
+C_KZG_RET compute_kzg_proofs_multi(KZGProof *out_proofs,
+                                   Bytes32 *out_ys,
+                                   const Blob *blob,
+                                   const Bytes32 *zs_bytes,
+                                   size_t k,
+                                   const KZGSettings *s);
+
 typedef struct { fr_t evals[FIELD_ELEMENTS_PER_BLOB]; } Polynomial;
 
 #ifdef UNIT_TESTS
@@ -133,11 +235,16 @@ void bytes_from_bls_field(Bytes32 *out, const fr_t *in);
 C_KZG_RET validate_kzg_g1(g1_t *out, const Bytes48 *b);
 void bytes_from_g1(Bytes48 *out, const g1_t *in);
 C_KZG_RET evaluate_polynomial_in_evaluation_form(fr_t *out, const Polynomial *p, const fr_t *x, const KZGSettings *s);
-C_KZG_RET blob_to_polynomial(Polynomial *p, const Blob *blob);
+C_KZG_RET blob_to_polynomial(Polynomial *p, const Blob *blob, const KZGSettings *s);
+C_KZG_RET poly_to_kzg_commitment(g1_t *out, uint64_t *nonzero_out, const Polynomial *p, const KZGSettings *s);
 C_KZG_RET bytes_to_bls_field(fr_t *out, const Bytes32 *b);
 uint32_t reverse_bits(uint32_t a);
 void compute_powers(fr_t *out, fr_t *x, uint64_t n);
 int log_2_byte(byte b);
+extern const uint64_t SCALE2_ROOT_OF_UNITY[][4];
+#ifdef __linux__
+size_t numa_node_count_from_list(FILE *f);
+#endif
 
 #endif
 
@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""
+Generate the roots of unity tables used by FFTSettings for a fixed width.
+
+The output is a C header with the same tables that new_fft_settings() would
+otherwise compute at runtime, in Blst's Montgomery `blst_fr` limb
+representation, so that the settings can point into read-only data.
+
+Usage: gen_roots_of_unity.py <width> > roots_of_unity.h
+"""
+
+import sys
+
+MODULUS = 52435875175126190479447740508185965837690552500527637822603658699938581184513
+PRIMITIVE_ROOT = 7
+
+# Montgomery form is x * 2^256 mod MODULUS
+R = pow(2, 256, MODULUS)
+
+
+def limbs(x):
+    m = (x * R) % MODULUS
+    return [(m >> (64 * i)) & 0xFFFFFFFFFFFFFFFF for i in range(4)]
+
+
+def reverse_bits(i, scale):
+    return int(format(i, "0{}b".format(scale))[::-1], 2) if scale else 0
+
+
+def table(name, values, comment):
+    out = ["/** {} */".format(comment)]
+    out.append("static const fr_t {}[{}] = {{".format(name, len(values)))
+    for v in values:
+        out.append("    {{{{0x{:016x}L, 0x{:016x}L, 0x{:016x}L, 0x{:016x}L}}}},".format(*limbs(v)))
+    out.append("};")
+    return "\n".join(out)
+
+
+def main():
+    width = int(sys.argv[1])
+    scale = width.bit_length() - 1
+    assert width > 0 and width == 1 << scale, "width must be a power of two"
+
+    root = pow(PRIMITIVE_ROOT, (MODULUS - 1) >> scale, MODULUS)
+    expanded = [pow(root, i, MODULUS) for i in range(width + 1)]
+    assert expanded[width] == 1 and (width == 1 or expanded[width // 2] != 1)
+
+    permuted = [expanded[reverse_bits(i, scale)] for i in range(width)]
+    inv_width = pow(width, MODULUS - 2, MODULUS)
+    div_width = [(x * inv_width) % MODULUS for x in permuted]
+
+    print("/*")
+    print(" * Generated by gen_roots_of_unity.py for a width of {}. Do not edit.".format(width))
+    print(" */")
+    print()
+    print("#define ROOTS_OF_UNITY_WIDTH {}".format(width))
+    print()
+    print(table("ROOTS_OF_UNITY", permuted, "Powers of the root of unity in bit-reversal permutation."))
+    print()
+    print(table("ROOTS_OF_UNITY_DIV_WIDTH", div_width, "The bit-reversal permuted powers, each divided by the width."))
+
+
+if __name__ == "__main__":
+    main()
@@ -8,7 +8,9 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 // Globals
@@ -16,6 +18,17 @@
 
 KZGSettings s;
 
+/*
+ * The real trusted setup only exists for 4096 field elements. Other sizes
+ * are tested with an insecure setup that is generated at startup.
+ */
+#if FIELD_ELEMENTS_PER_BLOB == 4096
+#define TRUSTED_SETUP_FILE "trusted_setup.txt"
+#else
+#define TRUSTED_SETUP_FILE "test_trusted_setup.txt"
+#define INSECURE_TRUSTED_SETUP
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 // Helper functions
 ///////////////////////////////////////////////////////////////////////////////
@@ -74,6 +87,56 @@ static void bytes48_from_hex(Bytes48 *out, const char *hex) {
     }
 }
 
+static void write_hex(FILE *fp, const uint8_t *bytes, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        fprintf(fp, "%02x", bytes[i]);
+    }
+    fprintf(fp, "\n");
+}
+
+/*
+ * Write a trusted setup with a publicly known secret, in the same format
+ * as trusted_setup.txt, for blobs of `width` field elements. This must never
+ * be used outside of tests.
+ */
+static void write_insecure_trusted_setup(const char *path, int width) {
+    const uint64_t one[4] = {1, 0, 0, 0};
+    const int num_g2 = 65;
+    Bytes32 seed = {{0}};
+    fr_t secret, power;
+    blst_scalar scalar;
+    g1_t g1;
+    g2_t g2;
+    uint8_t g1_bytes[48], g2_bytes[96];
+    FILE *fp;
+
+    fp = fopen(path, "w");
+    assert(fp != NULL);
+    fprintf(fp, "%d\n%d\n", width, num_g2);
+
+    hash_to_bls_field(&secret, &seed);
+
+    blst_fr_from_uint64(&power, one);
+    for (int i = 0; i < width; i++) {
+        blst_scalar_from_fr(&scalar, &power);
+        blst_p1_mult(&g1, blst_p1_generator(), scalar.b, 256);
+        blst_p1_compress(g1_bytes, &g1);
+        write_hex(fp, g1_bytes, sizeof(g1_bytes));
+        blst_fr_mul(&power, &power, &secret);
+    }
+
+    blst_fr_from_uint64(&power, one);
+    for (int i = 0; i < num_g2; i++) {
+        blst_scalar_from_fr(&scalar, &power);
+        blst_p2_mult(&g2, blst_p2_generator(), scalar.b, 256);
+        blst_p2_compress(g2_bytes, &g2);
+        write_hex(fp, g2_bytes, sizeof(g2_bytes));
+        blst_fr_mul(&power, &power, &secret);
+    }
+
+    fclose(fp);
+}
+
 static void get_rand_uint32(uint32_t *out) {
     Bytes32 b;
     get_rand_bytes32(&b);
@@ -179,6 +242,8 @@ static void test_blob_to_kzg_commitment__succeeds_point_at_infinity(void) {
     ASSERT_EQUALS(diff, 0);
 }
 
+/* The expected commitment depends on the real trusted setup */
+#if FIELD_ELEMENTS_PER_BLOB == 4096
 static void test_blob_to_kzg_commitment__succeeds_consistent_commitment(void) {
     C_KZG_RET ret;
     KZGCommitment c;
@@ -205,6 +270,77 @@ static void test_blob_to_kzg_commitment__succeeds_consistent_commitment(void) {
     diff = memcmp(c.bytes, expected_commitment.bytes, BYTES_PER_COMMITMENT);
     ASSERT_EQUALS(diff, 0);
 }
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// Tests for poly_to_kzg_commitment
+///////////////////////////////////////////////////////////////////////////////
+
+static void test_poly_to_kzg_commitment__reports_nonzero_count(void) {
+    C_KZG_RET ret;
+    Blob blob;
+    Polynomial poly;
+    g1_t commitment;
+    uint64_t nonzero;
+
+    /*
+     * Fill the first half of the blob and leave the rest zero-padded.
+     */
+    get_rand_blob(&blob);
+    memset(&blob.bytes[BYTES_PER_BLOB / 2], 0, BYTES_PER_BLOB / 2);
+    ret = blob_to_polynomial(&poly, &blob, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+
+    ret = poly_to_kzg_commitment(&commitment, &nonzero, &poly, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT_EQUALS(nonzero, FIELD_ELEMENTS_PER_BLOB / 2);
+}
+
+static void test_blob_to_kzg_commitment_with_sparsity__reports_nonzero_count(void) {
+    C_KZG_RET ret;
+    Blob blob;
+    KZGCommitment c1, c2;
+    uint64_t nonzero;
+
+    /* A quarter-filled blob commits as usual and reports its filled part */
+    get_rand_blob(&blob);
+    memset(&blob.bytes[BYTES_PER_BLOB / 4], 0, BYTES_PER_BLOB - BYTES_PER_BLOB / 4);
+    ret = blob_to_kzg_commitment_with_sparsity(&c1, &nonzero, &blob, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT_EQUALS(nonzero, FIELD_ELEMENTS_PER_BLOB / 4);
+
+    ret = blob_to_kzg_commitment(&c2, &blob, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT_EQUALS(memcmp(&c1, &c2, sizeof(KZGCommitment)), 0);
+}
+
+static void test_poly_to_kzg_commitment__succeeds_single_nonzero(void) {
+    C_KZG_RET ret;
+    Blob blob;
+    Polynomial poly;
+    g1_t commitment;
+    uint64_t nonzero;
+    Bytes48 a, b;
+    int diff;
+
+    /*
+     * A polynomial with a single evaluation of one at index 0 commits to
+     * exactly the first point of the commitment key.
+     */
+    memset(&blob, 0, sizeof(blob));
+    blob.bytes[0] = 1;
+    ret = blob_to_polynomial(&poly, &blob, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+
+    ret = poly_to_kzg_commitment(&commitment, &nonzero, &poly, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT_EQUALS(nonzero, 1);
+
+    bytes_from_g1(&a, &commitment);
+    blst_p1_affine_compress(b.bytes, &s.g1_values[0]);
+    diff = memcmp(a.bytes, b.bytes, sizeof(Bytes48));
+    ASSERT_EQUALS(diff, 0);
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 // Tests for validate_kzg_g1
@@ -473,6 +609,438 @@ static void test_compute_powers__expected_result(void) {
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Tests for the roots of unity
+///////////////////////////////////////////////////////////////////////////////
+
+static void test_roots_of_unity__tables_are_consistent(void) {
+    const FFTSettings *fs = s.fs;
+    uint64_t width = fs->max_width, vals[4] = {width, 0, 0, 0};
+    int unused_bit_len = 32 - __builtin_ctzll(width);
+    fr_t width_fr, root, power, tmp;
+    Bytes32 a, b;
+    int diff;
+
+    ASSERT_EQUALS(width, FIELD_ELEMENTS_PER_BLOB);
+    blst_fr_from_uint64(&width_fr, vals);
+
+    /*
+     * The table holds ascending powers of the root of unity in bit-reversal
+     * permutation, so the root itself is at the reversed index of one.
+     */
+    root = fs->roots_of_unity[reverse_bits(1) >> unused_bit_len];
+
+    /* The root is the one the runtime path derives, not just any root */
+    blst_fr_from_uint64(&tmp, SCALE2_ROOT_OF_UNITY[__builtin_ctzll(width)]);
+    bytes_from_bls_field(&a, &root);
+    bytes_from_bls_field(&b, &tmp);
+    diff = memcmp(a.bytes, b.bytes, sizeof(Bytes32));
+    ASSERT_EQUALS(diff, 0);
+
+    vals[0] = 1;
+    blst_fr_from_uint64(&power, vals);
+
+    for (uint64_t i = 0; i < width; i++) {
+        bytes_from_bls_field(&a, &fs->roots_of_unity[reverse_bits(i) >> unused_bit_len]);
+        bytes_from_bls_field(&b, &power);
+        diff = memcmp(a.bytes, b.bytes, sizeof(Bytes32));
+        ASSERT_EQUALS(diff, 0);
+        blst_fr_mul(&power, &power, &root);
+    }
+
+    /* The root has order exactly `width` */
+    bytes_from_bls_field(&a, &fs->roots_of_unity[0]);
+    bytes_from_bls_field(&b, &power);
+    diff = memcmp(a.bytes, b.bytes, sizeof(Bytes32));
+    ASSERT_EQUALS(diff, 0);
+    ASSERT_EQUALS(a.bytes[0], 1);
+
+    /* And dividing by the width can be undone */
+    for (uint64_t i = 0; i < width; i++) {
+        blst_fr_mul(&tmp, &fs->roots_of_unity_div_width[i], &width_fr);
+        bytes_from_bls_field(&a, &fs->roots_of_unity[i]);
+        bytes_from_bls_field(&b, &tmp);
+        diff = memcmp(a.bytes, b.bytes, sizeof(Bytes32));
+        ASSERT_EQUALS(diff, 0);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Tests for kzg_settings_memory_usage
+///////////////////////////////////////////////////////////////////////////////
+
+static void test_kzg_settings_memory_usage__counts_commitment_key(void) {
+    size_t usage = kzg_settings_memory_usage(&s);
+
+    /*
+     * The affine commitment key is always counted, and the total is below
+     * what the projective key and three root tables alone used to take.
+     */
+    ASSERT("usage includes the commitment key", usage >= FIELD_ELEMENTS_PER_BLOB * sizeof(blst_p1_affine));
+    ASSERT(
+        "usage is compact",
+        usage < FIELD_ELEMENTS_PER_BLOB * (sizeof(g1_t) + 3 * sizeof(fr_t))
+    );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Tests for load_trusted_setup_from_buffer
+///////////////////////////////////////////////////////////////////////////////
+
+static void test_load_trusted_setup_from_buffer__succeeds_file_contents(void) {
+    C_KZG_RET ret;
+    KZGSettings loaded;
+    Blob blob;
+    KZGCommitment c1, c2;
+    char *buf;
+    long len;
+    FILE *fp;
+
+    fp = fopen(TRUSTED_SETUP_FILE, "rb");
+    ASSERT("opened trusted setup", fp != NULL);
+    fseek(fp, 0, SEEK_END);
+    len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    buf = malloc(len);
+    ASSERT("allocated buffer", buf != NULL);
+    ASSERT_EQUALS(fread(buf, 1, len, fp), len);
+    fclose(fp);
+
+    ret = load_trusted_setup_from_buffer(&loaded, buf, len);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    free(buf);
+
+    get_rand_blob(&blob);
+    ret = blob_to_kzg_commitment(&c1, &blob, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = blob_to_kzg_commitment(&c2, &blob, &loaded);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT_EQUALS(memcmp(&c1, &c2, sizeof(KZGCommitment)), 0);
+
+    free_trusted_setup(&loaded);
+}
+
+static void test_load_trusted_setup_from_buffer__fails_wrong_length(void) {
+    C_KZG_RET ret;
+    KZGSettings loaded;
+    const char *buf = "3 65 00";
+
+    ret = load_trusted_setup_from_buffer(&loaded, buf, strlen(buf));
+    ASSERT_EQUALS(ret, C_KZG_BADARGS);
+}
+
+static void test_load_trusted_setup_from_buffer__fails_no_g1_points(void) {
+    C_KZG_RET ret;
+    KZGSettings loaded;
+    const char *buf = "0\n65\n";
+
+    ret = load_trusted_setup_from_buffer(&loaded, buf, strlen(buf));
+    ASSERT_EQUALS(ret, C_KZG_BADARGS);
+
+    /* The same applies to points given directly */
+    ret = load_trusted_setup(&loaded, NULL, 0, NULL, 0);
+    ASSERT_EQUALS(ret, C_KZG_BADARGS);
+}
+
+static void test_load_trusted_setup_from_buffer__fails_huge_counts(void) {
+    C_KZG_RET ret;
+    KZGSettings loaded;
+    char buf[64];
+
+    /* 2^59 G2 points would take 0 bytes once multiplied by 96 in 64 bits */
+    snprintf(buf, sizeof(buf), "%d 576460752303423488 00", FIELD_ELEMENTS_PER_BLOB);
+    ret = load_trusted_setup_from_buffer(&loaded, buf, strlen(buf));
+    ASSERT_EQUALS(ret, C_KZG_BADARGS);
+
+    snprintf(buf, sizeof(buf), "%d 18446744073709551615 00", FIELD_ELEMENTS_PER_BLOB);
+    ret = load_trusted_setup_from_buffer(&loaded, buf, strlen(buf));
+    ASSERT_EQUALS(ret, C_KZG_BADARGS);
+}
+
+static void test_load_trusted_setup_from_buffer__fails_truncated(void) {
+    C_KZG_RET ret;
+    KZGSettings loaded;
+    char buf[64];
+
+    snprintf(buf, sizeof(buf), "%d 65 97f1d3", FIELD_ELEMENTS_PER_BLOB);
+    ret = load_trusted_setup_from_buffer(&loaded, buf, strlen(buf));
+    ASSERT_EQUALS(ret, C_KZG_BADARGS);
+
+    /* The length is respected, not a terminating NUL */
+    ret = load_trusted_setup_from_buffer(&loaded, buf, 2);
+    ASSERT_EQUALS(ret, C_KZG_BADARGS);
+}
+
+static void test_load_trusted_setup_from_buffer__fails_invalid_hex(void) {
+    C_KZG_RET ret;
+    KZGSettings loaded;
+    char buf[64];
+
+    snprintf(buf, sizeof(buf), "%d 65 97f1zz", FIELD_ELEMENTS_PER_BLOB);
+    ret = load_trusted_setup_from_buffer(&loaded, buf, strlen(buf));
+    ASSERT_EQUALS(ret, C_KZG_BADARGS);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Tests for publish_trusted_setup and attach_trusted_setup
+///////////////////////////////////////////////////////////////////////////////
+
+static void test_attach_trusted_setup__matches_loaded_settings(void) {
+    C_KZG_RET ret;
+    KZGSettings attached;
+    Blob blob;
+    Bytes32 z, y;
+    KZGCommitment c1, c2;
+    KZGProof proof;
+    bool ok;
+    const char *path = "test_trusted_setup.image";
+
+    ret = publish_trusted_setup(path, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = attach_trusted_setup(&attached, path);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT("settings are attached", attached.image != NULL);
+    ASSERT("image is not counted", kzg_settings_memory_usage(&attached) < kzg_settings_memory_usage(&s));
+
+    get_rand_blob(&blob);
+    ret = blob_to_kzg_commitment(&c1, &blob, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = blob_to_kzg_commitment(&c2, &blob, &attached);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT_EQUALS(memcmp(&c1, &c2, sizeof(KZGCommitment)), 0);
+
+    /* Proofs from the attached settings verify, which uses the G2 points */
+    get_rand_field_element(&z);
+    ret = compute_kzg_proof(&proof, &blob, &z, &attached);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = evaluate_blob_at_points(&y, &blob, &z, 1, &attached);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = verify_kzg_proof(&ok, &c2, &z, &y, &proof, &attached);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT_EQUALS(ok, true);
+
+    free_trusted_setup(&attached);
+    remove(path);
+}
+
+static void test_attach_trusted_setup__fails_invalid_image(void) {
+    C_KZG_RET ret;
+    KZGSettings attached;
+    uint8_t garbage[128] = {0};
+    const char *path = "test_trusted_setup.image";
+    FILE *f;
+
+    ret = attach_trusted_setup(&attached, "test_trusted_setup.missing");
+    ASSERT_EQUALS(ret, C_KZG_BADARGS);
+
+    f = fopen(path, "wb");
+    ASSERT("opened image", f != NULL);
+    ASSERT_EQUALS(fwrite(garbage, 1, sizeof(garbage), f), sizeof(garbage));
+    fclose(f);
+
+    ret = attach_trusted_setup(&attached, path);
+    ASSERT_EQUALS(ret, C_KZG_BADARGS);
+    remove(path);
+}
+
+static void test_publish_trusted_setup__ignores_existing_temp_file(void) {
+    C_KZG_RET ret;
+    KZGSettings attached;
+    uint8_t garbage[128] = {0}, check[sizeof(garbage) + 1];
+    const char *path = "test_trusted_setup.image";
+    const char *tmp_path = "test_trusted_setup.image.tmp";
+    FILE *f;
+
+    /* A file at a predictable temporary name is neither written to nor used */
+    f = fopen(tmp_path, "wb");
+    ASSERT("opened temp file", f != NULL);
+    ASSERT_EQUALS(fwrite(garbage, 1, sizeof(garbage), f), sizeof(garbage));
+    fclose(f);
+
+    ret = publish_trusted_setup(path, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = attach_trusted_setup(&attached, path);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    free_trusted_setup(&attached);
+
+    f = fopen(tmp_path, "rb");
+    ASSERT("temp file is still there", f != NULL);
+    ASSERT_EQUALS(fread(check, 1, sizeof(check), f), sizeof(garbage));
+    fclose(f);
+
+    remove(tmp_path);
+    remove(path);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Tests for place_trusted_setup
+///////////////////////////////////////////////////////////////////////////////
+
+static void test_place_trusted_setup__matches_loaded_settings(void) {
+    C_KZG_RET ret;
+    KZGSettings placed;
+    Blob blob;
+    KZGCommitment c1, c2;
+    FILE *fp;
+
+    fp = fopen(TRUSTED_SETUP_FILE, "r");
+    ASSERT("opened trusted setup", fp != NULL);
+    ret = load_trusted_setup_file(&placed, fp);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    fclose(fp);
+
+    /* Huge pages and NUMA nodes are only hints, so this works anywhere */
+    ret = place_trusted_setup(&placed, KZG_PLACE_HUGE_PAGES | KZG_PLACE_NUMA_REPLICAS);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+
+    /* Settings can only be placed once */
+    ret = place_trusted_setup(&placed, KZG_PLACE_HUGE_PAGES);
+#ifdef __linux__
+    ASSERT_EQUALS(ret, C_KZG_BADARGS);
+#endif
+
+    get_rand_blob(&blob);
+    ret = blob_to_kzg_commitment(&c1, &blob, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = blob_to_kzg_commitment(&c2, &blob, &placed);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT_EQUALS(memcmp(&c1, &c2, sizeof(KZGCommitment)), 0);
+
+    free_trusted_setup(&placed);
+}
+
+#ifdef __linux__
+static size_t count_nodes(const char *list) {
+    size_t count;
+    FILE *f = tmpfile();
+
+    assert(f != NULL);
+    fputs(list, f);
+    rewind(f);
+    count = numa_node_count_from_list(f);
+    fclose(f);
+    return count;
+}
+
+static void test_numa_node_count_from_list__expected_values(void) {
+    ASSERT_EQUALS(count_nodes("0\n"), 1);
+    ASSERT_EQUALS(count_nodes("0-3\n"), 4);
+    ASSERT_EQUALS(count_nodes("0,2-3\n"), 4);
+    ASSERT_EQUALS(count_nodes("0-1,4\n"), 5);
+    ASSERT_EQUALS(count_nodes("0-1023\n"), 8 * sizeof(unsigned long));
+    ASSERT_EQUALS(count_nodes(""), 1);
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// Tests for load_trusted_setup_file_async
+///////////////////////////////////////////////////////////////////////////////
+
+static void test_load_trusted_setup_file_async__matches_loaded_settings(void) {
+    C_KZG_RET ret;
+    KZGSettingsLoader *loader;
+    const KZGSettings *loaded;
+    Blob blob;
+    KZGCommitment c1, c2;
+
+    ret = load_trusted_setup_file_async(&loader, TRUSTED_SETUP_FILE);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+
+    ret = wait_trusted_setup(&loaded, loader);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT("loader is ready", trusted_setup_is_ready(loader));
+    ASSERT("settings are loaded", loaded != NULL);
+
+    get_rand_blob(&blob);
+    ret = blob_to_kzg_commitment(&c1, &blob, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = blob_to_kzg_commitment(&c2, &blob, loaded);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT_EQUALS(memcmp(&c1, &c2, sizeof(KZGCommitment)), 0);
+
+    free_trusted_setup_loader(loader);
+}
+
+static void test_load_trusted_setup_file_async__fails_missing_file(void) {
+    C_KZG_RET ret;
+    KZGSettingsLoader *loader;
+    const KZGSettings *loaded;
+
+    ret = load_trusted_setup_file_async(&loader, "trusted_setup.missing");
+    ASSERT_EQUALS(ret, C_KZG_OK);
+
+    ret = wait_trusted_setup(&loaded, loader);
+    ASSERT_EQUALS(ret, C_KZG_BADARGS);
+    ASSERT("no settings", loaded == NULL);
+
+    free_trusted_setup_loader(loader);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Tests for blob size presets
+///////////////////////////////////////////////////////////////////////////////
+
+/* A preset smaller than the one this library was built for */
+#define SMALL_PRESET_WIDTH (FIELD_ELEMENTS_PER_BLOB > 4 ? 4 : 2)
+#define SMALL_PRESET_FILE "test_small_trusted_setup.txt"
+
+static void test_blob_presets__smaller_preset_round_trip(void) {
+    C_KZG_RET ret;
+    KZGSettings small;
+    FILE *fp;
+    const size_t n = 3, blob_size = SMALL_PRESET_WIDTH * BYTES_PER_FIELD_ELEMENT;
+    uint8_t blobs[3 * SMALL_PRESET_WIDTH * BYTES_PER_FIELD_ELEMENT];
+    KZGCommitment commitments[3];
+    KZGProof proof;
+    bool ok;
+
+    write_insecure_trusted_setup(SMALL_PRESET_FILE, SMALL_PRESET_WIDTH);
+    fp = fopen(SMALL_PRESET_FILE, "r");
+    ASSERT("opened small setup", fp != NULL);
+    ret = load_trusted_setup_file(&small, fp);
+    fclose(fp);
+    remove(SMALL_PRESET_FILE);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT_EQUALS(kzg_settings_field_elements_per_blob(&small), SMALL_PRESET_WIDTH);
+    ASSERT_EQUALS(kzg_settings_field_elements_per_blob(&s), FIELD_ELEMENTS_PER_BLOB);
+
+    /* Blobs are packed at the small preset's size */
+    for (size_t i = 0; i < n * SMALL_PRESET_WIDTH; i++) {
+        get_rand_field_element((Bytes32 *)&blobs[i * BYTES_PER_FIELD_ELEMENT]);
+    }
+    for (size_t i = 0; i < n; i++) {
+        ret = blob_to_kzg_commitment(&commitments[i], (const Blob *)&blobs[i * blob_size], &small);
+        ASSERT_EQUALS(ret, C_KZG_OK);
+    }
+
+    ret = compute_aggregate_kzg_proof(&proof, (const Blob *)blobs, n, &small);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = verify_aggregate_kzg_proof(&ok, (const Blob *)blobs, commitments, n, &proof, &small);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT_EQUALS(ok, true);
+
+    /* Swapping two blobs must break the proof */
+    KZGCommitment tmp = commitments[0];
+    commitments[0] = commitments[1];
+    commitments[1] = tmp;
+    ret = verify_aggregate_kzg_proof(&ok, (const Blob *)blobs, commitments, n, &proof, &small);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT_EQUALS(ok, false);
+
+    free_trusted_setup(&small);
+}
+
+static void test_blob_presets__fails_larger_than_build(void) {
+    C_KZG_RET ret;
+    KZGSettings larger;
+    char header[64];
+    int len;
+
+    len = snprintf(header, sizeof header, "%d\n65\n", FIELD_ELEMENTS_PER_BLOB * 2);
+    ret = load_trusted_setup_from_buffer(&larger, header, (size_t)len);
+    ASSERT_EQUALS(ret, C_KZG_BADARGS);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Tests for log_2_byte
 ///////////////////////////////////////////////////////////////////////////////
@@ -527,7 +1095,7 @@ static void test_compute_and_verify_kzg_proof__succeeds_round_trip(void) {
 
     /* Now let's attempt to verify the proof */
     /* First convert the blob to field elements */
-    ret = blob_to_polynomial(&poly, &blob);
+    ret = blob_to_polynomial(&poly, &blob, &s);
     ASSERT_EQUALS(ret, C_KZG_OK);
 
     /* Also convert z to a field element */
@@ -549,6 +1117,84 @@ static void test_compute_and_verify_kzg_proof__succeeds_round_trip(void) {
     ASSERT_EQUALS(ok, 1);
 }
 
+static void test_compute_and_verify_kzg_proof__succeeds_zero_padded_blob(void) {
+    C_KZG_RET ret;
+    Bytes48 proof;
+    Bytes32 z, y;
+    KZGCommitment c;
+    Blob blob;
+    Polynomial poly;
+    fr_t y_fr, z_fr;
+    bool ok;
+
+    /* Only the first quarter of the blob holds data */
+    get_rand_field_element(&z);
+    get_rand_blob(&blob);
+    memset(&blob.bytes[BYTES_PER_BLOB / 4], 0, BYTES_PER_BLOB - BYTES_PER_BLOB / 4);
+
+    ret = blob_to_kzg_commitment(&c, &blob, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+
+    ret = compute_kzg_proof(&proof, &blob, &z, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+
+    ret = blob_to_polynomial(&poly, &blob, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = bytes_to_bls_field(&z_fr, &z);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = evaluate_polynomial_in_evaluation_form(&y_fr, &poly, &z_fr, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    bytes_from_bls_field(&y, &y_fr);
+
+    ret = verify_kzg_proof(&ok, &c, &z, &y, &proof, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT_EQUALS(ok, 1);
+}
+
+static void test_compute_and_verify_kzg_proof__succeeds_narrow_scalars(void) {
+    /*
+     * Rollups commonly pack 31 data bytes into each field element, and some
+     * blobs hold even smaller values. Check that commitments and proofs are
+     * still consistent when every scalar is that narrow.
+     */
+    const int WIDTHS[] = {31, 1};
+    for (int w = 0; w < 2; w++) {
+        C_KZG_RET ret;
+        Bytes48 proof;
+        Bytes32 z, y;
+        KZGCommitment c;
+        Blob blob;
+        Polynomial poly;
+        fr_t y_fr, z_fr;
+        bool ok;
+
+        get_rand_field_element(&z);
+        get_rand_blob(&blob);
+        for (int i = 0; i < FIELD_ELEMENTS_PER_BLOB; i++) {
+            uint8_t *field_element = &blob.bytes[i * BYTES_PER_FIELD_ELEMENT];
+            memset(&field_element[WIDTHS[w]], 0, BYTES_PER_FIELD_ELEMENT - WIDTHS[w]);
+        }
+
+        ret = blob_to_kzg_commitment(&c, &blob, &s);
+        ASSERT_EQUALS(ret, C_KZG_OK);
+
+        ret = compute_kzg_proof(&proof, &blob, &z, &s);
+        ASSERT_EQUALS(ret, C_KZG_OK);
+
+        ret = blob_to_polynomial(&poly, &blob, &s);
+        ASSERT_EQUALS(ret, C_KZG_OK);
+        ret = bytes_to_bls_field(&z_fr, &z);
+        ASSERT_EQUALS(ret, C_KZG_OK);
+        ret = evaluate_polynomial_in_evaluation_form(&y_fr, &poly, &z_fr, &s);
+        ASSERT_EQUALS(ret, C_KZG_OK);
+        bytes_from_bls_field(&y, &y_fr);
+
+        ret = verify_kzg_proof(&ok, &c, &z, &y, &proof, &s);
+        ASSERT_EQUALS(ret, C_KZG_OK);
+        ASSERT_EQUALS(ok, 1);
+    }
+}
+
 static void test_compute_and_verify_kzg_proof__succeeds_within_domain(void) {
     const int SAMPLES = 25;
     for (int i = 0; i < SAMPLES; i++) {
@@ -566,7 +1212,7 @@ static void test_compute_and_verify_kzg_proof__succeeds_within_domain(void) {
         ret = blob_to_kzg_commitment(&c, &blob, &s);
         ASSERT_EQUALS(ret, C_KZG_OK);
 
-        ret = blob_to_polynomial(&poly, &blob);
+        ret = blob_to_polynomial(&poly, &blob, &s);
         ASSERT_EQUALS(ret, C_KZG_OK);
 
         z_fr = s.fs->roots_of_unity[i];
@@ -592,6 +1238,313 @@ static void test_compute_and_verify_kzg_proof__succeeds_within_domain(void) {
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Tests for evaluate_blob_at_points
+///////////////////////////////////////////////////////////////////////////////
+
+static void test_evaluate_blob_at_points__matches_single_evaluations(void) {
+    C_KZG_RET ret;
+    const int k = 4;
+    Blob blob;
+    Bytes32 xs[k], ys[k], expected_y;
+    Polynomial poly;
+    fr_t x_fr, y_fr;
+    int diff;
+
+    get_rand_blob(&blob);
+    ret = blob_to_polynomial(&poly, &blob, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+
+    /* Mix points outside the domain with one inside it */
+    get_rand_field_element(&xs[0]);
+    bytes_from_bls_field(&xs[1], &s.fs->roots_of_unity[2]);
+    get_rand_field_element(&xs[2]);
+    get_rand_field_element(&xs[3]);
+
+    ret = evaluate_blob_at_points(ys, &blob, xs, k, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+
+    for (int j = 0; j < k; j++) {
+        ret = bytes_to_bls_field(&x_fr, &xs[j]);
+        ASSERT_EQUALS(ret, C_KZG_OK);
+        ret = evaluate_polynomial_in_evaluation_form(&y_fr, &poly, &x_fr, &s);
+        ASSERT_EQUALS(ret, C_KZG_OK);
+        bytes_from_bls_field(&expected_y, &y_fr);
+        diff = memcmp(ys[j].bytes, expected_y.bytes, sizeof(Bytes32));
+        ASSERT_EQUALS(diff, 0);
+    }
+}
+
+static void test_evaluate_blob_at_points__succeeds_constant_polynomial(void) {
+    C_KZG_RET ret;
+    const int k = 3;
+    Blob blob;
+    Bytes32 xs[k], ys[k];
+    int diff;
+
+    /*
+     * A blob where every evaluation is the same value is the constant
+     * polynomial, so every point evaluates to that value.
+     */
+    for (int i = 0; i < FIELD_ELEMENTS_PER_BLOB; i++) {
+        memset(&blob.bytes[i * BYTES_PER_FIELD_ELEMENT], 0, BYTES_PER_FIELD_ELEMENT);
+        blob.bytes[i * BYTES_PER_FIELD_ELEMENT] = 42;
+    }
+    for (int j = 0; j < k; j++) {
+        get_rand_field_element(&xs[j]);
+    }
+
+    ret = evaluate_blob_at_points(ys, &blob, xs, k, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+
+    for (int j = 0; j < k; j++) {
+        diff = memcmp(ys[j].bytes, blob.bytes, sizeof(Bytes32));
+        ASSERT_EQUALS(diff, 0);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Tests for compute_kzg_proofs_multi
+///////////////////////////////////////////////////////////////////////////////
+
+static void test_compute_kzg_proofs_multi__matches_single_proofs(void) {
+    C_KZG_RET ret;
+    const int k = 4;
+    Blob blob;
+    KZGCommitment c;
+    Bytes32 zs[k], ys[k];
+    KZGProof proofs[k], expected_proof;
+    Polynomial poly;
+    fr_t y_fr, z_fr;
+    bool ok;
+    int diff;
+
+    get_rand_blob(&blob);
+    ret = blob_to_kzg_commitment(&c, &blob, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = blob_to_polynomial(&poly, &blob, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+
+    /* Mix points outside the domain with one inside it */
+    get_rand_field_element(&zs[0]);
+    get_rand_field_element(&zs[1]);
+    bytes_from_bls_field(&zs[2], &s.fs->roots_of_unity[1]);
+    get_rand_field_element(&zs[3]);
+
+    ret = compute_kzg_proofs_multi(proofs, ys, &blob, zs, k, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+
+    for (int j = 0; j < k; j++) {
+        /* The proof should match the single-point computation */
+        ret = compute_kzg_proof(&expected_proof, &blob, &zs[j], &s);
+        ASSERT_EQUALS(ret, C_KZG_OK);
+        diff = memcmp(proofs[j].bytes, expected_proof.bytes, sizeof(KZGProof));
+        ASSERT_EQUALS(diff, 0);
+
+        /* And so should the evaluation */
+        ret = bytes_to_bls_field(&z_fr, &zs[j]);
+        ASSERT_EQUALS(ret, C_KZG_OK);
+        ret = evaluate_polynomial_in_evaluation_form(&y_fr, &poly, &z_fr, &s);
+        ASSERT_EQUALS(ret, C_KZG_OK);
+        Bytes32 expected_y;
+        bytes_from_bls_field(&expected_y, &y_fr);
+        diff = memcmp(ys[j].bytes, expected_y.bytes, sizeof(Bytes32));
+        ASSERT_EQUALS(diff, 0);
+
+        ret = verify_kzg_proof(&ok, &c, &zs[j], &ys[j], &proofs[j], &s);
+        ASSERT_EQUALS(ret, C_KZG_OK);
+        ASSERT_EQUALS(ok, 1);
+    }
+}
+
+static void test_compute_kzg_proofs_multi__fails_invalid_point(void) {
+    C_KZG_RET ret;
+    Blob blob;
+    Bytes32 zs[2], ys[2];
+    KZGProof proofs[2];
+
+    get_rand_blob(&blob);
+    get_rand_field_element(&zs[0]);
+
+    /* BLS_MODULUS is not a valid field element */
+    bytes32_from_hex(
+        &zs[1],
+        "01000000fffffffffe5bfeff02a4bd5305d8a10908d83933487d9d2953a7ed73"
+    );
+
+    ret = compute_kzg_proofs_multi(proofs, ys, &blob, zs, 2, &s);
+    ASSERT_EQUALS(ret, C_KZG_BADARGS);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Tests for executors
+///////////////////////////////////////////////////////////////////////////////
+
+static void test_thread_pool__matches_serial_results(void) {
+    C_KZG_RET ret;
+    KZGExecutor *pool;
+    KZGSettings pooled;
+    /* On the heap, as three blobs of the largest sizes do not fit on the stack */
+    Blob *blobs = calloc(3, sizeof(Blob));
+    Bytes32 zs[3], ys[3], expected_ys[3];
+    KZGProof proofs[3], expected_proofs[3], proof, expected_proof;
+    KZGCommitment commitment, expected_commitment;
+    int diff;
+
+    ASSERT("allocated blobs", blobs != NULL);
+    ret = new_kzg_thread_pool(&pool, 4);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    /* A shallow copy shares the tables, and must not be freed */
+    pooled = s;
+    set_trusted_setup_executor(&pooled, pool);
+
+    for (int i = 0; i < 3; i++) {
+        get_rand_blob(&blobs[i]);
+        get_rand_field_element(&zs[i]);
+    }
+
+    ret = blob_to_kzg_commitment(&commitment, &blobs[0], &pooled);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = blob_to_kzg_commitment(&expected_commitment, &blobs[0], &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    diff = memcmp(commitment.bytes, expected_commitment.bytes, sizeof(KZGCommitment));
+    ASSERT_EQUALS(diff, 0);
+
+    ret = compute_kzg_proofs_multi(proofs, ys, &blobs[0], zs, 3, &pooled);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = compute_kzg_proofs_multi(expected_proofs, expected_ys, &blobs[0], zs, 3, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    diff = memcmp(proofs, expected_proofs, sizeof(proofs));
+    ASSERT_EQUALS(diff, 0);
+    diff = memcmp(ys, expected_ys, sizeof(ys));
+    ASSERT_EQUALS(diff, 0);
+
+    ret = compute_aggregate_kzg_proof(&proof, blobs, 3, &pooled);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = compute_aggregate_kzg_proof(&expected_proof, blobs, 3, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    diff = memcmp(proof.bytes, expected_proof.bytes, sizeof(KZGProof));
+    ASSERT_EQUALS(diff, 0);
+
+    free_kzg_thread_pool(pool);
+    free(blobs);
+}
+
+static void count_task(void *arg, size_t i) {
+    int *counts = arg;
+    counts[i]++;
+}
+
+static void test_thread_pool__runs_every_index_once(void) {
+    C_KZG_RET ret;
+    KZGExecutor *pool;
+    int counts[100] = {0};
+
+    ret = new_kzg_thread_pool(&pool, 0);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ASSERT("has threads", pool->num_threads >= 1);
+
+    pool->parallel_for(pool->ctx, count_task, counts, 100);
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQUALS(counts[i], 1);
+    }
+
+    free_kzg_thread_pool(pool);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Tests for allocators
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+    size_t allocated;
+    size_t freed;
+    bool misaligned;
+} AllocationCounts;
+
+/* Over-allocate, and keep the pointer to free just before the aligned space */
+static void *counting_malloc(void *ctx, size_t size, size_t alignment) {
+    AllocationCounts *counts = ctx;
+    uint8_t *raw = malloc(size + alignment + sizeof(void *));
+    if (raw == NULL) return NULL;
+    uintptr_t aligned = ((uintptr_t)raw + sizeof(void *) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    ((void **)aligned)[-1] = raw;
+    counts->allocated++;
+    return (void *)aligned;
+}
+
+static void *counting_calloc(void *ctx, size_t count, size_t size, size_t alignment) {
+    void *p = counting_malloc(ctx, count * size, alignment);
+    if (p != NULL) memset(p, 0, count * size);
+    return p;
+}
+
+static void counting_free(void *ctx, void *p) {
+    AllocationCounts *counts = ctx;
+    if ((uintptr_t)p % 64 != 0) counts->misaligned = true;
+    counts->freed++;
+    free(((void **)p)[-1]);
+}
+
+static void test_set_kzg_allocator__routes_all_allocations(void) {
+    C_KZG_RET ret;
+    AllocationCounts counts = {0, 0, false};
+    KZGAllocator counting = {counting_malloc, counting_calloc, counting_free, &counts};
+    KZGCommitment commitment;
+    KZGProof proof;
+    KZGSettings loaded;
+    Blob *blobs = calloc(2, sizeof(Blob));
+    FILE *fp;
+
+    ASSERT("allocated blobs", blobs != NULL);
+    get_rand_blob(&blobs[0]);
+    get_rand_blob(&blobs[1]);
+
+    /* Cached buffers must go back to the allocator they came from */
+    release_kzg_thread_scratch();
+    set_kzg_allocator(&counting);
+
+    ret = blob_to_kzg_commitment(&commitment, &blobs[0], &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    ret = compute_aggregate_kzg_proof(&proof, blobs, 2, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+
+    fp = fopen(TRUSTED_SETUP_FILE, "r");
+    ASSERT("opened setup", fp != NULL);
+    ret = load_trusted_setup_file(&loaded, fp);
+    fclose(fp);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    free_trusted_setup(&loaded);
+
+    release_kzg_thread_scratch();
+    set_kzg_allocator(NULL);
+
+    ASSERT("allocated", counts.allocated > 0);
+    ASSERT_EQUALS(counts.freed, counts.allocated);
+    ASSERT_EQUALS(counts.misaligned, false);
+    free(blobs);
+}
+
+static void test_release_kzg_thread_scratch__commitments_unchanged(void) {
+    C_KZG_RET ret;
+    Blob blob;
+    KZGCommitment before, after;
+    int diff;
+
+    get_rand_blob(&blob);
+
+    ret = blob_to_kzg_commitment(&before, &blob, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+    release_kzg_thread_scratch();
+    /* Releasing twice is harmless */
+    release_kzg_thread_scratch();
+    ret = blob_to_kzg_commitment(&after, &blob, &s);
+    ASSERT_EQUALS(ret, C_KZG_OK);
+
+    diff = memcmp(before.bytes, after.bytes, sizeof(KZGCommitment));
+    ASSERT_EQUALS(diff, 0);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Main logic
 ///////////////////////////////////////////////////////////////////////////////
@@ -600,7 +1553,11 @@ static void setup(void) {
     FILE *fp;
     C_KZG_RET ret;
 
-    fp = fopen("trusted_setup.txt", "r");
+#ifdef INSECURE_TRUSTED_SETUP
+    write_insecure_trusted_setup(TRUSTED_SETUP_FILE, FIELD_ELEMENTS_PER_BLOB);
+#endif
+
+    fp = fopen(TRUSTED_SETUP_FILE, "r");
     assert(fp != NULL);
 
     ret = load_trusted_setup_file(&s, fp);
@@ -611,15 +1568,94 @@ static void setup(void) {
 
 static void teardown(void) {
     free_trusted_setup(&s);
+#ifdef INSECURE_TRUSTED_SETUP
+    remove(TRUSTED_SETUP_FILE);
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef BENCHMARK
+/* How long each function is run for, so that slow calls are still averaged */
+#define BENCHMARK_NS 1000000000ull
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
 }
 
+/* Call expr, which returns a C_KZG_RET, until BENCHMARK_NS have passed and print the time per call */
+#define BENCH(name, expr)                                                                                              \
+    do {                                                                                                               \
+        uint64_t start = now_ns(), calls = 0, elapsed;                                                                 \
+        do {                                                                                                           \
+            C_KZG_RET bench_ret = (expr);                                                                              \
+            assert(bench_ret == C_KZG_OK);                                                                             \
+            (void)bench_ret;                                                                                           \
+            calls++;                                                                                                   \
+        } while ((elapsed = now_ns() - start) < BENCHMARK_NS);                                                         \
+        printf("%-36s %6d field elements %12.3f ms/op\n", (name), FIELD_ELEMENTS_PER_BLOB,                           \
+               (double)elapsed / 1e6 / (double)calls);                                                                \
+    } while (0)
+
+static void run_benchmarks(void) {
+    const size_t n = 16;
+    Blob *blobs = calloc(n, sizeof(Blob));
+    Bytes48 *commitments = calloc(n, sizeof(Bytes48));
+    KZGProof proof, aggregated_proof;
+    Bytes32 z, y;
+    char name[64];
+    C_KZG_RET ret;
+    bool ok;
+
+    assert(blobs != NULL && commitments != NULL);
+    for (size_t i = 0; i < n; i++) {
+        get_rand_blob(&blobs[i]);
+        ret = blob_to_kzg_commitment((KZGCommitment *)&commitments[i], &blobs[i], &s);
+        assert(ret == C_KZG_OK);
+    }
+    get_rand_field_element(&z);
+    ret = compute_kzg_proof(&proof, &blobs[0], &z, &s);
+    assert(ret == C_KZG_OK);
+    ret = evaluate_blob_at_points(&y, &blobs[0], &z, 1, &s);
+    assert(ret == C_KZG_OK);
+    (void)ret;
+
+    BENCH("blob_to_kzg_commitment", blob_to_kzg_commitment((KZGCommitment *)&commitments[0], &blobs[0], &s));
+    BENCH("compute_kzg_proof", compute_kzg_proof(&proof, &blobs[0], &z, &s));
+    BENCH("verify_kzg_proof", verify_kzg_proof(&ok, &commitments[0], &z, &y, &proof, &s));
+    for (size_t i = 1; i <= n; i *= 4) {
+        snprintf(name, sizeof(name), "compute_aggregate_kzg_proof(n=%zu)", i);
+        BENCH(name, compute_aggregate_kzg_proof(&aggregated_proof, blobs, i, &s));
+        snprintf(name, sizeof(name), "verify_aggregate_kzg_proof(n=%zu)", i);
+        BENCH(name, verify_aggregate_kzg_proof(&ok, blobs, commitments, i, &aggregated_proof, &s));
+    }
+
+    free(blobs);
+    free(commitments);
+}
+#endif
+
 int main(void) {
     setup();
+#ifdef BENCHMARK
+    run_benchmarks();
+    teardown();
+    return 0;
+#endif
     RUN(test_blob_to_kzg_commitment__succeeds_x_less_than_modulus);
     RUN(test_blob_to_kzg_commitment__fails_x_equal_to_modulus);
     RUN(test_blob_to_kzg_commitment__fails_x_greater_than_modulus);
     RUN(test_blob_to_kzg_commitment__succeeds_point_at_infinity);
+#if FIELD_ELEMENTS_PER_BLOB == 4096
     RUN(test_blob_to_kzg_commitment__succeeds_consistent_commitment);
+#endif
+    RUN(test_poly_to_kzg_commitment__reports_nonzero_count);
+    RUN(test_poly_to_kzg_commitment__succeeds_single_nonzero);
+    RUN(test_blob_to_kzg_commitment_with_sparsity__reports_nonzero_count);
     RUN(test_validate_kzg_g1__succeeds_round_trip);
     RUN(test_validate_kzg_g1__succeeds_correct_point);
     RUN(test_validate_kzg_g1__fails_not_in_g1);
@@ -637,9 +1673,38 @@ int main(void) {
     RUN(test_reverse_bits__some_bits_are_one);
     RUN(test_reverse_bits__all_bits_are_one);
     RUN(test_compute_powers__expected_result);
+    RUN(test_roots_of_unity__tables_are_consistent);
+    RUN(test_kzg_settings_memory_usage__counts_commitment_key);
+    RUN(test_load_trusted_setup_from_buffer__succeeds_file_contents);
+    RUN(test_load_trusted_setup_from_buffer__fails_wrong_length);
+    RUN(test_load_trusted_setup_from_buffer__fails_no_g1_points);
+    RUN(test_load_trusted_setup_from_buffer__fails_huge_counts);
+    RUN(test_load_trusted_setup_from_buffer__fails_truncated);
+    RUN(test_load_trusted_setup_from_buffer__fails_invalid_hex);
+    RUN(test_attach_trusted_setup__matches_loaded_settings);
+    RUN(test_attach_trusted_setup__fails_invalid_image);
+    RUN(test_publish_trusted_setup__ignores_existing_temp_file);
+    RUN(test_place_trusted_setup__matches_loaded_settings);
+#ifdef __linux__
+    RUN(test_numa_node_count_from_list__expected_values);
+#endif
+    RUN(test_load_trusted_setup_file_async__matches_loaded_settings);
+    RUN(test_load_trusted_setup_file_async__fails_missing_file);
+    RUN(test_blob_presets__smaller_preset_round_trip);
+    RUN(test_blob_presets__fails_larger_than_build);
     RUN(test_log_2_byte__expected_values);
     RUN(test_compute_and_verify_kzg_proof__succeeds_round_trip);
+    RUN(test_compute_and_verify_kzg_proof__succeeds_zero_padded_blob);
+    RUN(test_compute_and_verify_kzg_proof__succeeds_narrow_scalars);
     RUN(test_compute_and_verify_kzg_proof__succeeds_within_domain);
+    RUN(test_evaluate_blob_at_points__matches_single_evaluations);
+    RUN(test_evaluate_blob_at_points__succeeds_constant_polynomial);
+    RUN(test_compute_kzg_proofs_multi__matches_single_proofs);
+    RUN(test_compute_kzg_proofs_multi__fails_invalid_point);
+    RUN(test_thread_pool__matches_serial_results);
+    RUN(test_thread_pool__runs_every_index_once);
+    RUN(test_set_kzg_allocator__routes_all_allocations);
+    RUN(test_release_kzg_thread_scratch__commitments_unchanged);
     teardown();
 
     return TEST_REPORT();